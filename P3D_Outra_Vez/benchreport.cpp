@@ -0,0 +1,63 @@
+/***********************************************************************
+ * Implementação do Relatório de Benchmark
+ ***********************************************************************/
+
+#include "benchreport.h"
+#include "jsonvalue.h"
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+double BenchmarkReport::percentile(double fraction) const {
+    if (frameMs.empty()) return 0.0;
+
+    std::vector<double> sorted(frameMs);
+    std::sort(sorted.begin(), sorted.end());
+    const size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+bool BenchmarkReport::write(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    const double total = std::accumulate(frameMs.begin(), frameMs.end(), 0.0);
+    const double avg = frameMs.empty() ? 0.0 : total / frameMs.size();
+    const double minMs = frameMs.empty() ? 0.0 : *std::min_element(frameMs.begin(), frameMs.end());
+    const double maxMs = frameMs.empty() ? 0.0 : *std::max_element(frameMs.begin(), frameMs.end());
+
+    file << "{\n";
+    file << "  \"renderer\": "; JsonValue::writeString(file, renderer); file << ",\n";
+    file << "  \"backend\": "; JsonValue::writeString(file, backend); file << ",\n";
+    file << "  \"resolution\": [" << width << ", " << height << "],\n";
+    file << "  \"scene\": {\n";
+    file << "    \"tables\": " << scene.tables << ",\n";
+    file << "    \"balls_per_table\": " << scene.ballsPerTable << ",\n";
+    file << "    \"sharing\": \"" << StressScene::sharingName(scene.sharing) << "\",\n";
+    file << "    \"accent_lights\": " << scene.accentLights << ",\n";
+    file << "    \"balls\": " << balls << ",\n";
+    file << "    \"models_loaded\": " << modelsLoaded << ",\n";
+    file << "    \"ball_rendering\": \"" << (impostors ? "impostor" : "mesh") << "\"\n";
+    file << "  },\n";
+    file << "  \"frames\": " << frameMs.size() << ",\n";
+    file << "  \"load_ms\": " << loadMs << ",\n";
+    file << "  \"frame_ms\": {\n";
+    file << "    \"avg\": " << avg << ",\n";
+    file << "    \"min\": " << minMs << ",\n";
+    file << "    \"p50\": " << percentile(0.50) << ",\n";
+    file << "    \"p95\": " << percentile(0.95) << ",\n";
+    file << "    \"p99\": " << percentile(0.99) << ",\n";
+    file << "    \"max\": " << maxMs << "\n";
+    file << "  },\n";
+    file << "  \"gpu_ms\": " << gpuMs << ",\n";
+    file << "  \"draw_calls\": " << drawCalls << ",\n";
+    file << "  \"triangles\": " << triangles << ",\n";
+    file << "  \"visible_objects\": " << visibleObjects << ",\n";
+    file << "  \"memory\": {\n";
+    file << "    \"texture_bytes\": " << textureBytes << ",\n";
+    file << "    \"buffer_bytes\": " << bufferBytes << "\n";
+    file << "  },\n";
+    file << "  \"worker_threads\": " << workerThreads << "\n";
+    file << "}\n";
+    return file.good();
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string: identificação do renderer e caminho do relatório
+ * - vector: tempo de cada frame medido
+ * - stressscene: dimensão da cena medida
+ */
+#include <string>
+#include <vector>
+#include "stressscene.h"
+
+/**
+ * @brief Resultado de uma execução de benchmark (--bench), gravado em JSON
+ *
+ * Os tempos de frame são guardados um a um e resumidos no relatório em
+ * média, mínimo, máximo e percentis p50/p95/p99. Os contadores de
+ * desenho são médias por frame; a memória é o valor no fim da execução.
+ */
+struct BenchmarkReport {
+    std::string renderer;           // GL_RENDERER
+    std::string backend;            // Contexto headless usado
+    int width = 0;
+    int height = 0;
+
+    SceneConfig scene;              // Mesas, bolas por mesa, partilha e luzes de destaque
+    size_t balls = 0;               // Bolas na cena
+    size_t modelsLoaded = 0;        // Modelos lidos do disco (as instâncias não contam)
+    bool impostors = false;         // Bolas desenhadas como impostores em vez de malhas
+
+    double loadMs = 0.0;            // Tempo de init(): shaders, mesas, bolas e texturas
+    std::vector<double> frameMs;    // Tempo de cada frame (com glFinish)
+    double gpuMs = -1.0;            // Média do scope "frame" na GPU (-1 = não medido)
+    double drawCalls = 0.0;         // Chamadas de desenho por frame
+    double triangles = 0.0;         // Triângulos submetidos por frame
+    double visibleObjects = 0.0;    // Bolas e mesas que passaram o culling da vista principal, por frame
+    long long textureBytes = 0;     // Memória de texturas e renderbuffers
+    long long bufferBytes = 0;      // Memória de buffers
+    unsigned int workerThreads = 0;
+
+    /**
+     * @brief Percentil dos tempos de frame
+     * @param fraction Percentil entre 0 e 1
+     */
+    double percentile(double fraction) const;
+
+    /**
+     * @brief Grava o relatório em JSON
+     * @return false se o ficheiro não pôde ser criado
+     */
+    bool write(const std::string& path) const;
+};
\ No newline at end of file
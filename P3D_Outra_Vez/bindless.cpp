@@ -0,0 +1,48 @@
+/***********************************************************************
+ * Implementação da Tabela de Texturas Bindless
+ ***********************************************************************/
+
+#include "bindless.h"
+#include "gpumemory.h"
+#include <iostream>
+
+bool BindlessMaterials::build(const std::vector<GLuint>& textures) {
+    release();
+
+    for (GLuint texture : textures) {
+        if (!texture) {
+            std::cerr << "Bindless: material sem textura" << std::endl;
+            release();
+            return false;
+        }
+
+        const GLuint64 handle = glGetTextureHandleARB(texture);
+        glMakeTextureHandleResidentARB(handle);
+        handles.push_back(handle);
+    }
+
+    // Tabela imutável: os handles não mudam enquanto as texturas existirem
+    glGenBuffers(1, &handleBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, handleBuffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, handles.size() * sizeof(GLuint64), handles.data(), 0);
+    GpuMemory::addBuffer(handles.size() * sizeof(GLuint64));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return true;
+}
+
+void BindlessMaterials::bind(GLuint binding) const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, handleBuffer);
+}
+
+void BindlessMaterials::release() {
+    for (GLuint64 handle : handles) {
+        glMakeTextureHandleNonResidentARB(handle);
+    }
+
+    if (handleBuffer) {
+        glDeleteBuffers(1, &handleBuffer);
+        GpuMemory::addBuffer(-static_cast<long long>(handles.size() * sizeof(GLuint64)));
+        handleBuffer = 0;
+    }
+    handles.clear();
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - vector: tabela de handles
+ * - GL/glew: ARB_bindless_texture e SSBOs
+ */
+#include <vector>
+#include <GL/glew.h>
+
+/**
+ * @brief Tabela de texturas bindless (ARB_bindless_texture)
+ *
+ * Cada textura difusa recebe um handle de 64 bits, tornado residente, e
+ * os handles são guardados num SSBO indexado pelo índice do material.
+ * O shader constrói o sampler diretamente a partir do handle, por isso
+ * não há glBindTexture por desenho nem a restrição do array de texturas
+ * (todas com as mesmas dimensões).
+ *
+ * Depois de obtido o handle, os parâmetros da textura ficam imutáveis.
+ */
+class BindlessMaterials {
+public:
+    ~BindlessMaterials() { release(); }
+
+    /**
+     * @brief Obtém os handles das texturas e envia-os para a GPU
+     * @param textures Texturas difusas, pela ordem dos índices de material
+     * @return false se alguma textura estiver em falta
+     */
+    bool build(const std::vector<GLuint>& textures);
+
+    /**
+     * @brief Liga a tabela de handles a um ponto de ligação de SSBO
+     */
+    void bind(GLuint binding) const;
+
+    /**
+     * @brief Torna os handles não residentes e liberta o buffer
+     */
+    void release();
+
+    bool isReady() const { return handleBuffer != 0; }
+    size_t size() const { return handles.size(); }
+
+private:
+    std::vector<GLuint64> handles;   // Um handle residente por material
+    GLuint handleBuffer = 0;         // SSBO com os handles (uvec2 no shader)
+};
\ No newline at end of file
@@ -0,0 +1,346 @@
+/***********************************************************************
+ * Implementação da Captura Assíncrona de Frames
+ *
+ * Leitura para PBOs com fences no ciclo principal; inversão das linhas,
+ * codificação PNG e escrita em disco numa thread de trabalho.
+ ***********************************************************************/
+
+#include "capture.h"
+#include "cpuprofiler.h"
+#include "gpumemory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Tempo monotónico em segundos
+ */
+static double captureClock() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/***********************************************************************
+ * Codificador PNG mínimo
+ *
+ * Usa blocos deflate sem compressão: os ficheiros são maiores, mas não é
+ * preciso nenhuma biblioteca externa e a codificação é apenas uma cópia.
+ ***********************************************************************/
+
+static uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t size) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void putBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+/**
+ * @brief Acrescenta um chunk PNG (comprimento, tipo, dados, CRC)
+ */
+static void writeChunk(FILE* file, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> header;
+    putBigEndian(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+
+    uint32_t crc = crc32Update(0xFFFFFFFFu, header.data() + 4, 4);
+    crc = crc32Update(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+
+    std::vector<unsigned char> trailer;
+    putBigEndian(trailer, crc);
+
+    fwrite(header.data(), 1, header.size(), file);
+    fwrite(data.data(), 1, data.size(), file);
+    fwrite(trailer.data(), 1, trailer.size(), file);
+}
+
+/**
+ * @brief Grava uma imagem RGBA (de cima para baixo) como PNG RGB de 8 bits
+ */
+static bool writePNG(const std::string& filename, const unsigned char* rgba, int width, int height) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (!file) return false;
+
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, sizeof(signature), file);
+
+    std::vector<unsigned char> ihdr;
+    putBigEndian(ihdr, width);
+    putBigEndian(ihdr, height);
+    ihdr.push_back(8);  // Bits por canal
+    ihdr.push_back(2);  // Tipo de cor: RGB
+    ihdr.push_back(0);  // Compressão deflate
+    ihdr.push_back(0);  // Filtro adaptativo
+    ihdr.push_back(0);  // Sem entrelaçamento
+    writeChunk(file, "IHDR", ihdr);
+
+    // Linhas com o byte de filtro 0 (nenhum) seguido dos pixels RGB
+    const size_t rowSize = static_cast<size_t>(width) * 3 + 1;
+    std::vector<unsigned char> raw(rowSize * height);
+    for (int y = 0; y < height; ++y) {
+        unsigned char* row = &raw[y * rowSize];
+        const unsigned char* src = rgba + static_cast<size_t>(y) * width * 4;
+        row[0] = 0;
+        for (int x = 0; x < width; ++x) {
+            row[1 + x * 3 + 0] = src[x * 4 + 0];
+            row[1 + x * 3 + 1] = src[x * 4 + 1];
+            row[1 + x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+
+    // Stream zlib com blocos "stored" de até 65535 bytes
+    std::vector<unsigned char> idat;
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+
+    uint32_t adlerA = 1, adlerB = 0;
+    size_t offset = 0;
+    do {
+        const size_t blockSize = std::min<size_t>(raw.size() - offset, 65535);
+        const bool last = offset + blockSize == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(static_cast<unsigned char>(blockSize & 0xFF));
+        idat.push_back(static_cast<unsigned char>(blockSize >> 8));
+        idat.push_back(static_cast<unsigned char>(~blockSize & 0xFF));
+        idat.push_back(static_cast<unsigned char>((~blockSize >> 8) & 0xFF));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+
+        for (size_t i = offset; i < offset + blockSize; ++i) {
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        offset += blockSize;
+    } while (offset < raw.size());
+    putBigEndian(idat, (adlerB << 16) | adlerA);
+
+    writeChunk(file, "IDAT", idat);
+    writeChunk(file, "IEND", std::vector<unsigned char>());
+
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+/***********************************************************************
+ * FrameCapture
+ ***********************************************************************/
+
+bool FrameCapture::start(GLsizei newWidth, GLsizei newHeight, const std::string& newPath) {
+    stop();
+
+    width = newWidth;
+    height = newHeight;
+    frameBytes = static_cast<size_t>(width) * height * 4;
+    path = newPath;
+
+    const size_t dot = path.find_last_of('.');
+    format = (dot != std::string::npos && path.substr(dot) == ".png") ? CAPTURE_PNG : CAPTURE_RAW;
+
+    if (format == CAPTURE_RAW) {
+        rawFile = fopen(path.c_str(), "wb");
+        if (!rawFile) {
+            std::cerr << "Nao foi possivel criar " << path << std::endl;
+            return false;
+        }
+    }
+
+    // PBOs só de leitura pelo CPU
+    for (Slot& slot : slots) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+        GpuMemory::addBuffer(frameBytes);
+        slot.fence = nullptr;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    writeIndex = readIndex = 0;
+    frameCounter = capturedFrames = droppedFrames = captureCalls = 0;
+    captureSeconds = 0.0;
+    quit = false;
+    active = true;
+    worker = std::thread(&FrameCapture::workerLoop, this);
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (!active) return;
+
+    // Os frames ainda na GPU são recolhidos, mesmo que seja preciso esperar
+    collect(true);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    worker.join();
+
+    for (Slot& slot : slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.pbo);
+        GpuMemory::addBuffer(-static_cast<long long>(frameBytes));
+        slot = Slot();
+    }
+    if (rawFile) {
+        fclose(rawFile);
+        rawFile = nullptr;
+    }
+    pool.clear();
+    active = false;
+}
+
+void FrameCapture::capture(GLuint framebuffer) {
+    if (!active) return;
+    const double start = captureClock();
+
+    // Primeiro liberta as entradas cujas leituras já terminaram
+    collect(false);
+
+    Slot& slot = slots[writeIndex];
+    if (slot.fence) {
+        // Anel cheio: a GPU ainda não acabou a leitura mais antiga
+        ++droppedFrames;
+    }
+    else {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        if (framebuffer == 0) glReadBuffer(GL_BACK);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.frame = frameCounter;
+        writeIndex = (writeIndex + 1) % RING_SIZE;
+    }
+    ++frameCounter;
+
+    captureSeconds += captureClock() - start;
+    ++captureCalls;
+}
+
+void FrameCapture::collect(bool wait) {
+    while (slots[readIndex].fence) {
+        Slot& slot = slots[readIndex];
+
+        // Sem espera no ciclo normal; em stop() espera até um segundo por leitura
+        const GLuint64 timeout = wait ? 1000000000ull : 0;
+        const GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        readIndex = (readIndex + 1) % RING_SIZE;
+
+        // Reutiliza um buffer da pool; com a fila cheia o frame é descartado
+        Job job;
+        job.frame = slot.frame;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queue.size() >= MAX_QUEUED) {
+                ++droppedFrames;
+                continue;
+            }
+            if (!pool.empty()) {
+                job.pixels.swap(pool.back());
+                pool.pop_back();
+            }
+        }
+        job.pixels.resize(frameBytes);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+        if (mapped) {
+            memcpy(job.pixels.data(), mapped, frameBytes);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!mapped) {
+            ++droppedFrames;
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(job));
+        }
+        wake.notify_one();
+        ++capturedFrames;
+    }
+}
+
+void FrameCapture::workerLoop() {
+    PROFILE_THREAD("captura");
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return quit || !queue.empty(); });
+            if (queue.empty()) return; // quit com a fila vazia
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        encode(job);
+
+        // Devolve o buffer à pool
+        std::lock_guard<std::mutex> lock(mutex);
+        pool.push_back(std::move(job.pixels));
+    }
+}
+
+void FrameCapture::encode(Job& job) {
+    PROFILE_ZONE("FrameCapture::encode");
+
+    // O OpenGL lê de baixo para cima; os ficheiros começam pela linha de cima
+    const size_t rowSize = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> row(rowSize);
+    for (GLsizei y = 0; y < height / 2; ++y) {
+        unsigned char* top = &job.pixels[y * rowSize];
+        unsigned char* bottom = &job.pixels[(height - 1 - y) * rowSize];
+        memcpy(row.data(), top, rowSize);
+        memcpy(top, bottom, rowSize);
+        memcpy(bottom, row.data(), rowSize);
+    }
+
+    if (format == CAPTURE_RAW) {
+        fwrite(job.pixels.data(), 1, job.pixels.size(), rawFile);
+        return;
+    }
+
+    // nome.png -> nome_000001.png
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_%06u", job.frame);
+    std::string filename = path;
+    filename.insert(filename.size() - 4, suffix);
+    if (!writePNG(filename, job.pixels.data(), width, height)) {
+        std::cerr << "Falha ao gravar " << filename << std::endl;
+    }
+}
\ No newline at end of file
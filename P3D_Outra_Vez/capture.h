@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string, vector, deque: destino e fila de imagens a codificar
+ * - thread, mutex, condition_variable: codificação numa thread de trabalho
+ * - GL/glew: pixel buffer objects e fences
+ */
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <GL/glew.h>
+
+/**
+ * @brief Formato de gravação da captura
+ */
+enum CaptureFormat {
+    CAPTURE_RAW,  // Todos os frames num único ficheiro RGBA (ex.: ffmpeg -f rawvideo -pix_fmt rgba)
+    CAPTURE_PNG   // Um ficheiro PNG por frame (nome_000001.png, ...)
+};
+
+/**
+ * @brief Captura de frames sem bloquear o pipeline
+ *
+ * glReadPixels para memória do cliente obriga o CPU a esperar que a GPU
+ * termine o frame. Aqui a leitura é feita para um anel de pixel buffer
+ * objects (PBOs): o glReadPixels apenas agenda a cópia na GPU e uma fence
+ * indica quando esta terminou. Dois ou três frames depois, o PBO já está
+ * pronto e é mapeado sem espera; os pixels são copiados para um buffer
+ * da pool e entregues a uma thread que trata da codificação e da escrita
+ * em disco.
+ *
+ * Se a GPU ou a thread de codificação ficarem para trás, o frame é
+ * descartado (e contado) em vez de atrasar o ciclo principal.
+ */
+class FrameCapture {
+public:
+    ~FrameCapture() { stop(); }
+
+    /**
+     * @brief Começa a captura
+     * @param width, height Dimensões da imagem a capturar
+     * @param path Ficheiro de destino; com extensão .png grava uma sequência de PNGs
+     * @return true se o ficheiro de destino pôde ser criado
+     */
+    bool start(GLsizei width, GLsizei height, const std::string& path);
+
+    /**
+     * @brief Termina a captura: recolhe os frames pendentes e espera pela thread
+     */
+    void stop();
+
+    /**
+     * @brief Agenda a leitura do frame atual e recolhe leituras anteriores já concluídas
+     * @param framebuffer Framebuffer a ler (0 = back buffer da janela)
+     */
+    void capture(GLuint framebuffer);
+
+    bool isActive() const { return active; }
+
+    unsigned int getCapturedFrames() const { return capturedFrames; }
+    unsigned int getDroppedFrames() const { return droppedFrames; }
+
+    /**
+     * @brief Tempo médio gasto por capture() no ciclo principal, em milissegundos
+     */
+    double getAverageCaptureMs() const { return captureCalls ? captureSeconds * 1000.0 / captureCalls : 0.0; }
+
+private:
+    static const int RING_SIZE = 3;        // PBOs em voo (frames de latência)
+    static const size_t MAX_QUEUED = 8;    // Imagens à espera de codificação
+
+    // Entrada do anel de PBOs
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;            // nullptr = livre
+        unsigned int frame = 0;            // Número do frame lido para este PBO
+    };
+
+    // Imagem entregue à thread de trabalho
+    struct Job {
+        unsigned int frame = 0;
+        std::vector<unsigned char> pixels; // RGBA, de baixo para cima
+    };
+
+    /**
+     * @brief Recolhe os PBOs cujas fences já sinalizaram
+     * @param wait Espera pelas fences (usado apenas em stop())
+     */
+    void collect(bool wait);
+
+    void workerLoop();
+    void encode(Job& job);
+
+    Slot slots[RING_SIZE];
+    int writeIndex = 0;                    // Próxima entrada a receber um glReadPixels
+    int readIndex = 0;                     // Entrada mais antiga em voo
+
+    GLsizei width = 0;
+    GLsizei height = 0;
+    size_t frameBytes = 0;
+    CaptureFormat format = CAPTURE_RAW;
+    std::string path;
+    FILE* rawFile = nullptr;
+
+    bool active = false;
+    unsigned int frameCounter = 0;
+    unsigned int capturedFrames = 0;
+    unsigned int droppedFrames = 0;
+    double captureSeconds = 0.0;
+    unsigned int captureCalls = 0;
+
+    // Fila de imagens para a thread de trabalho e pool de buffers reutilizados
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> queue;
+    std::vector<std::vector<unsigned char>> pool;
+    bool quit = false;
+};
\ No newline at end of file
@@ -0,0 +1,399 @@
+/***********************************************************************
+ * Implementação da Iluminação Clustered Forward
+ *
+ * Atribui as luzes pontuais aos clusters do frustum de cada vista (em
+ * paralelo e em lotes SIMD) e envia as listas para texturas de buffer,
+ * lidas por lighting.frag.
+ ***********************************************************************/
+
+#include "clusteredlighting.h"
+#include "renderqueue.h"
+#include "taskpool.h"
+#include "cpuprofiler.h"
+#include "gpumemory.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static_assert(ClusteredLighting::MAX_VIEWS == RenderQueue::MAX_VIEWS, "uma grelha por vista da fila");
+
+// Luzes por lote SIMD (o preenchimento das listas de cada fatia é múltiplo disto)
+#if defined(__AVX__)
+static constexpr size_t LIGHT_BATCH = 8;
+#else
+static constexpr size_t LIGHT_BATCH = 4;
+#endif
+
+bool ClusteredLighting::init() {
+    destroy();
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &blockAlignment);
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    // Passo entre blocos: sizeof(GridBlock) arredondado a um múltiplo do alinhamento (cada deslocamento tem de o respeitar)
+    const GLint alignment = std::max<GLint>(blockAlignment, 1);
+    blockAlignment = (static_cast<GLint>(sizeof(GridBlock)) + alignment - 1) / alignment * alignment;
+
+    // Um texel em cada buffer, para que as texturas nunca fiquem sem dados
+    static const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+    static const GLuint zeros[4] = { 0, 0, 0, 0 };
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+    for (int i = 0; i < 3; ++i) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, sizeof(zeros), zeros, GL_STREAM_DRAW);
+        bufferBytes[i] = sizeof(zeros);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // O primeiro bloco fica sempre vazio: vistas sem grelha só recebem a luz ambiente
+    gridBlocks.assign(blockAlignment, 0);
+    glGenBuffers(1, &gridBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, gridBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, gridBlocks.size(), gridBlocks.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    bufferBytes[3] = gridBlocks.size();
+    GpuMemory::addBuffer(bufferBytes[0] + bufferBytes[1] + bufferBytes[2] + bufferBytes[3]);
+
+    for (GLintptr& offset : viewBlock) offset = 0;
+    for (ViewGrid& grid : grids) grid.projection = glm::mat4(0.0f);
+    return gridBuffer != 0;
+}
+
+void ClusteredLighting::destroy() {
+    if (gridBuffer) {
+        GpuMemory::addBuffer(-(bufferBytes[0] + bufferBytes[1] + bufferBytes[2] + bufferBytes[3]));
+        glDeleteTextures(3, textures);
+        glDeleteBuffers(3, buffers);
+        glDeleteBuffers(1, &gridBuffer);
+        gridBuffer = 0;
+        for (int i = 0; i < 3; ++i) textures[i] = buffers[i] = 0;
+        for (GLsizeiptr& bytes : bufferBytes) bytes = 0;
+    }
+}
+
+void ClusteredLighting::setupProgram(GLuint program) const {
+    if (!program) return;
+    glProgramUniform1i(program, glGetUniformLocation(program, "lightData"), LIGHT_DATA_UNIT);
+    glProgramUniform1i(program, glGetUniformLocation(program, "clusterRanges"), CLUSTER_RANGES_UNIT);
+    glProgramUniform1i(program, glGetUniformLocation(program, "lightIndices"), LIGHT_INDICES_UNIT);
+
+    const GLuint block = glGetUniformBlockIndex(program, "ClusterGrid");
+    if (block != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, block, GRID_BLOCK_BINDING);
+    }
+}
+
+/**
+ * @brief Calcula as fatias e as caixas dos clusters de uma projeção
+ *
+ * Os cantos de cada tile são levados de volta ao espaço da vista nos
+ * planos near e far; a linha entre os dois pontos dá, por interpolação
+ * em z, o canto em qualquer profundidade (vale para perspetiva e para
+ * projeções ortográficas).
+ */
+void ClusteredLighting::buildGrid(ViewGrid& grid, const glm::mat4& projection) {
+    grid.projection = projection;
+    grid.perspective = projection[2][3] != 0.0f;
+
+    const glm::mat4 inverse = glm::inverse(projection);
+    auto unproject = [&inverse](float x, float y, float z) {
+        const glm::vec4 p = inverse * glm::vec4(x, y, z, 1.0f);
+        return glm::vec3(p) / p.w;
+    };
+    grid.nearDepth = -unproject(0.0f, 0.0f, -1.0f).z;
+    grid.farDepth = -unproject(0.0f, 0.0f, 1.0f).z;
+
+    // Fatias logarítmicas numa perspetiva (clusters de proporções semelhantes), lineares numa ortográfica
+    for (int k = 0; k <= GRID_Z; ++k) {
+        const float t = static_cast<float>(k) / GRID_Z;
+        grid.sliceNear[k] = grid.perspective
+            ? grid.nearDepth * std::pow(grid.farDepth / grid.nearDepth, t)
+            : grid.nearDepth + (grid.farDepth - grid.nearDepth) * t;
+    }
+
+    // Linhas dos cantos dos tiles: (GRID_X + 1) x (GRID_Y + 1) pares de pontos near/far
+    std::vector<glm::vec3> cornerNear((GRID_X + 1) * (GRID_Y + 1));
+    std::vector<glm::vec3> cornerFar(cornerNear.size());
+    for (int y = 0; y <= GRID_Y; ++y) {
+        for (int x = 0; x <= GRID_X; ++x) {
+            const float ndcX = -1.0f + 2.0f * x / GRID_X;
+            const float ndcY = -1.0f + 2.0f * y / GRID_Y;
+            cornerNear[y * (GRID_X + 1) + x] = unproject(ndcX, ndcY, -1.0f);
+            cornerFar[y * (GRID_X + 1) + x] = unproject(ndcX, ndcY, 1.0f);
+        }
+    }
+    auto cornerAt = [&](int x, int y, float depth) {
+        const glm::vec3& a = cornerNear[y * (GRID_X + 1) + x];
+        const glm::vec3& b = cornerFar[y * (GRID_X + 1) + x];
+        const float t = (-depth - a.z) / (b.z - a.z);
+        return a + (b - a) * t;
+    };
+
+    grid.minX.resize(CLUSTERS_PER_VIEW);
+    grid.minY.resize(CLUSTERS_PER_VIEW);
+    grid.minZ.resize(CLUSTERS_PER_VIEW);
+    grid.maxX.resize(CLUSTERS_PER_VIEW);
+    grid.maxY.resize(CLUSTERS_PER_VIEW);
+    grid.maxZ.resize(CLUSTERS_PER_VIEW);
+    for (int k = 0; k < GRID_Z; ++k) {
+        for (int y = 0; y < GRID_Y; ++y) {
+            for (int x = 0; x < GRID_X; ++x) {
+                glm::vec3 lo(1.0e30f), hi(-1.0e30f);
+                for (int corner = 0; corner < 8; ++corner) {
+                    const glm::vec3 p = cornerAt(x + (corner & 1), y + ((corner >> 1) & 1), grid.sliceNear[k + (corner >> 2)]);
+                    lo = glm::min(lo, p);
+                    hi = glm::max(hi, p);
+                }
+                const int cluster = (k * GRID_Y + y) * GRID_X + x;
+                grid.minX[cluster] = lo.x; grid.minY[cluster] = lo.y; grid.minZ[cluster] = lo.z;
+                grid.maxX[cluster] = hi.x; grid.maxY[cluster] = hi.y; grid.maxZ[cluster] = hi.z;
+            }
+        }
+    }
+}
+
+void ClusteredLighting::update(const std::vector<PointLight>& lights, const RenderQueue& queue,
+    const std::vector<uint8_t>& viewIds, TaskPool& pool) {
+    PROFILE_ZONE("ClusteredLighting::update");
+
+    for (GLintptr& offset : viewBlock) offset = 0;
+    frameViews.clear();
+    lightData.clear();
+    visibleLights = 0;
+    indexCount = 0;
+    maxClusterLights = 0;
+    droppedIndices = 0;
+    if (!isReady()) return;
+
+    // Esferas de influência no mundo, partilhadas pelo culling de todas as vistas
+    lightBounds.clear();
+    for (const PointLight& light : lights) {
+        lightBounds.add(light.position, light.radius);
+    }
+
+    // Luzes visíveis de cada vista, no espaço dessa vista (2 texels por luz)
+    const size_t maxLights = static_cast<size_t>(maxTexels) / 2;
+    for (uint8_t viewId : viewIds) {
+        const RenderView& view = queue.getView(viewId);
+        CullStats stats;
+        cullSpheres(Frustum::fromViewProjection(view.projection * view.view), lightBounds, visible, stats);
+        if (visible.empty() || lightData.size() / 2 + visible.size() > maxLights) continue;
+
+        if (view.projection != grids[viewId].projection) {
+            buildGrid(grids[viewId], view.projection);
+        }
+
+        FrameView frameView;
+        frameView.viewId = viewId;
+        frameView.firstLight = static_cast<uint32_t>(lightData.size() / 2);
+        frameView.lightCount = static_cast<uint32_t>(visible.size());
+        frameView.viewport = glm::vec4(view.x, view.y, std::max(view.width, 1), std::max(view.height, 1));
+        for (uint32_t index : visible) {
+            const PointLight& light = lights[index];
+            lightData.push_back(glm::vec4(glm::vec3(view.view * glm::vec4(light.position, 1.0f)), light.radius));
+            lightData.push_back(glm::vec4(light.color * light.intensity, 0.0f));
+        }
+        frameViews.push_back(frameView);
+        visibleLights += frameView.lightCount;
+    }
+
+    // Uma tarefa por fatia de cada vista
+    const size_t taskCount = frameViews.size() * GRID_Z;
+    if (tasks.size() < taskCount) tasks.resize(taskCount);
+    for (size_t i = 0; i < taskCount; ++i) {
+        tasks[i].view = static_cast<int>(i / GRID_Z);
+        tasks[i].slice = static_cast<int>(i % GRID_Z);
+    }
+    pool.parallelFor(taskCount, [this](size_t i) { assignSlice(tasks[i]); });
+
+    // Junta as listas das fatias pela ordem dos clusters
+    const size_t clusterSlice = GRID_X * GRID_Y;
+    clusterRanges.assign(frameViews.size() * CLUSTERS_PER_VIEW * 2, 0);
+    lightIndices.clear();
+    for (size_t i = 0; i < taskCount; ++i) {
+        const SliceTask& task = tasks[i];
+        const size_t firstCluster = task.view * CLUSTERS_PER_VIEW + task.slice * clusterSlice;
+        size_t read = 0;
+        for (size_t c = 0; c < clusterSlice; ++c) {
+            uint32_t count = task.counts[c];
+            const size_t room = static_cast<size_t>(maxTexels) - lightIndices.size();
+            if (count > room) {
+                droppedIndices += static_cast<unsigned int>(count - room);
+                count = static_cast<uint32_t>(room);
+            }
+            clusterRanges[(firstCluster + c) * 2] = static_cast<GLuint>(lightIndices.size());
+            clusterRanges[(firstCluster + c) * 2 + 1] = count;
+            lightIndices.insert(lightIndices.end(), task.indices.begin() + read, task.indices.begin() + read + count);
+            read += task.counts[c];
+            maxClusterLights = std::max(maxClusterLights, count);
+        }
+    }
+    indexCount = static_cast<unsigned int>(lightIndices.size());
+
+    upload();
+}
+
+/**
+ * @brief Testa as luzes de uma fatia contra as caixas dos seus clusters
+ *
+ * Corre numa thread de trabalho: lê os dados do frame e escreve apenas
+ * na própria tarefa. As luzes que não tocam o intervalo de profundidade
+ * da fatia são descartadas primeiro; as restantes são testadas, em lotes
+ * SIMD, pela distância entre o centro e a caixa de cada cluster.
+ */
+void ClusteredLighting::assignSlice(SliceTask& task) const {
+    const FrameView& view = frameViews[task.view];
+    const ViewGrid& grid = grids[view.viewId];
+    const float sliceNear = grid.sliceNear[task.slice];
+    const float sliceFar = grid.sliceNear[task.slice + 1];
+
+    task.lightX.clear();
+    task.lightY.clear();
+    task.lightZ.clear();
+    task.lightRadius.clear();
+    task.lightIds.clear();
+    task.indices.clear();
+    for (uint32_t i = 0; i < view.lightCount; ++i) {
+        const glm::vec4& light = lightData[(view.firstLight + i) * 2];
+        const float depth = -light.z;
+        if (depth + light.w < sliceNear || depth - light.w > sliceFar) continue;
+        task.lightX.push_back(light.x);
+        task.lightY.push_back(light.y);
+        task.lightZ.push_back(light.z);
+        task.lightRadius.push_back(light.w);
+        task.lightIds.push_back(view.firstLight + i);
+    }
+
+    // Completa o último lote com luzes de raio 0 muito longe de qualquer cluster
+    const size_t count = task.lightIds.size();
+    const size_t padded = (count + LIGHT_BATCH - 1) & ~(LIGHT_BATCH - 1);
+    task.lightX.resize(padded, 1.0e18f);
+    task.lightY.resize(padded, 0.0f);
+    task.lightZ.resize(padded, 0.0f);
+    task.lightRadius.resize(padded, 0.0f);
+
+    const int firstCluster = task.slice * GRID_X * GRID_Y;
+    for (int c = 0; c < GRID_X * GRID_Y; ++c) {
+        const int cluster = firstCluster + c;
+        const size_t before = task.indices.size();
+
+#if defined(__AVX__)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 minX = _mm256_set1_ps(grid.minX[cluster]), maxX = _mm256_set1_ps(grid.maxX[cluster]);
+        const __m256 minY = _mm256_set1_ps(grid.minY[cluster]), maxY = _mm256_set1_ps(grid.maxY[cluster]);
+        const __m256 minZ = _mm256_set1_ps(grid.minZ[cluster]), maxZ = _mm256_set1_ps(grid.maxZ[cluster]);
+        for (size_t i = 0; i < padded; i += 8) {
+            const __m256 x = _mm256_loadu_ps(&task.lightX[i]);
+            const __m256 y = _mm256_loadu_ps(&task.lightY[i]);
+            const __m256 z = _mm256_loadu_ps(&task.lightZ[i]);
+            const __m256 r = _mm256_loadu_ps(&task.lightRadius[i]);
+
+            // Distância do centro à caixa em cada eixo (0 dentro do intervalo)
+            const __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minX, x), _mm256_sub_ps(x, maxX)), zero);
+            const __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minY, y), _mm256_sub_ps(y, maxY)), zero);
+            const __m256 dz = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minZ, z), _mm256_sub_ps(z, maxZ)), zero);
+            __m256 d2 = _mm256_mul_ps(dx, dx);
+            d2 = _mm256_add_ps(d2, _mm256_mul_ps(dy, dy));
+            d2 = _mm256_add_ps(d2, _mm256_mul_ps(dz, dz));
+
+            const int mask = _mm256_movemask_ps(_mm256_cmp_ps(d2, _mm256_mul_ps(r, r), _CMP_LE_OQ));
+            for (int bit = 0; bit < 8; ++bit) {
+                if (mask & (1 << bit)) task.indices.push_back(task.lightIds[i + bit]);
+            }
+        }
+#else
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 minX = _mm_set1_ps(grid.minX[cluster]), maxX = _mm_set1_ps(grid.maxX[cluster]);
+        const __m128 minY = _mm_set1_ps(grid.minY[cluster]), maxY = _mm_set1_ps(grid.maxY[cluster]);
+        const __m128 minZ = _mm_set1_ps(grid.minZ[cluster]), maxZ = _mm_set1_ps(grid.maxZ[cluster]);
+        for (size_t i = 0; i < padded; i += 4) {
+            const __m128 x = _mm_loadu_ps(&task.lightX[i]);
+            const __m128 y = _mm_loadu_ps(&task.lightY[i]);
+            const __m128 z = _mm_loadu_ps(&task.lightZ[i]);
+            const __m128 r = _mm_loadu_ps(&task.lightRadius[i]);
+
+            // Distância do centro à caixa em cada eixo (0 dentro do intervalo)
+            const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+            const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+            const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)), zero);
+            __m128 d2 = _mm_mul_ps(dx, dx);
+            d2 = _mm_add_ps(d2, _mm_mul_ps(dy, dy));
+            d2 = _mm_add_ps(d2, _mm_mul_ps(dz, dz));
+
+            const int mask = _mm_movemask_ps(_mm_cmple_ps(d2, _mm_mul_ps(r, r)));
+            for (int bit = 0; bit < 4; ++bit) {
+                if (mask & (1 << bit)) task.indices.push_back(task.lightIds[i + bit]);
+            }
+        }
+#endif
+
+        task.counts[c] = static_cast<uint32_t>(task.indices.size() - before);
+    }
+}
+
+/**
+ * @brief Envia os dados do frame e os blocos das vistas
+ *
+ * Os buffers são realocados com glBufferData em cada frame, para que o
+ * driver não tenha de esperar que a GPU acabe de ler os do anterior.
+ */
+void ClusteredLighting::upload() {
+    const void* data[3] = { lightData.data(), clusterRanges.data(), lightIndices.data() };
+    const GLsizeiptr sizes[3] = {
+        static_cast<GLsizeiptr>(lightData.size() * sizeof(glm::vec4)),
+        static_cast<GLsizeiptr>(clusterRanges.size() * sizeof(GLuint)),
+        static_cast<GLsizeiptr>(lightIndices.size() * sizeof(GLuint))
+    };
+    for (int i = 0; i < 3; ++i) {
+        if (sizes[i] == 0) continue;
+        glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, sizes[i], data[i], GL_STREAM_DRAW);
+        GpuMemory::addBuffer(sizes[i] - bufferBytes[i]);
+        bufferBytes[i] = sizes[i];
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // Bloco vazio seguido de um bloco por vista iluminada
+    gridBlocks.assign((frameViews.size() + 1) * blockAlignment, 0);
+    for (size_t i = 0; i < frameViews.size(); ++i) {
+        const FrameView& frameView = frameViews[i];
+        const ViewGrid& grid = grids[frameView.viewId];
+        const glm::vec4& viewport = frameView.viewport;
+
+        GridBlock block;
+        block.tileOrigin = glm::vec4(viewport.x, viewport.y, GRID_X / viewport.z, GRID_Y / viewport.w);
+        if (grid.perspective) {
+            const float scale = GRID_Z / std::log(grid.farDepth / grid.nearDepth);
+            block.depthSlicing = glm::vec4(scale, -std::log(grid.nearDepth) * scale, 1.0f, 0.0f);
+        }
+        else {
+            const float scale = GRID_Z / (grid.farDepth - grid.nearDepth);
+            block.depthSlicing = glm::vec4(scale, -grid.nearDepth * scale, 0.0f, 0.0f);
+        }
+        block.gridSize[0] = GRID_X;
+        block.gridSize[1] = GRID_Y;
+        block.gridSize[2] = GRID_Z;
+        block.gridSize[3] = static_cast<GLuint>(i * CLUSTERS_PER_VIEW);
+
+        viewBlock[frameView.viewId] = static_cast<GLintptr>((i + 1) * blockAlignment);
+        std::memcpy(&gridBlocks[viewBlock[frameView.viewId]], &block, sizeof(block));
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, gridBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, gridBlocks.size(), gridBlocks.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    GpuMemory::addBuffer(static_cast<GLsizeiptr>(gridBlocks.size()) - bufferBytes[3]);
+    bufferBytes[3] = gridBlocks.size();
+}
+
+void ClusteredLighting::bindView(uint8_t viewId) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, GRID_BLOCK_BINDING, gridBuffer, viewBlock[viewId], sizeof(GridBlock));
+    for (int i = 0; i < 3; ++i) {
+        glActiveTexture(GL_TEXTURE0 + LIGHT_DATA_UNIT + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: índices das luzes e das vistas
+ * - vector: luzes da cena e listas por cluster
+ * - GL/glew: buffers e texturas de buffer
+ * - glm: posições, cores e matrizes das vistas
+ * - frustum: culling das luzes por vista (esferas de influência em SoA)
+ */
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "frustum.h"
+
+class RenderQueue;
+class TaskPool;
+
+/**
+ * Estrutura para luz pontual
+ * Define posição e propriedades de uma fonte de luz
+ */
+struct PointLight {
+    glm::vec3 position;  // Posição da luz no espaço 3D
+    glm::vec3 color;     // Cor da luz
+    float intensity;     // Intensidade da luz
+    float radius;        // Alcance: a luz não ilumina nada além desta distância
+
+    PointLight() :
+        position(5.0f, 5.0f, 0.0f),
+        color(1.0f),
+        intensity(1.0f),
+        radius(10.0f) {
+    }
+};
+
+/**
+ * @brief Iluminação clustered forward de muitas luzes pontuais
+ *
+ * O frustum de cada vista é dividido numa grelha 3D de clusters:
+ * GRID_X x GRID_Y tiles no ecrã e GRID_Z fatias em profundidade
+ * (logarítmicas numa perspetiva, lineares numa projeção ortográfica).
+ * Em cada frame, as luzes visíveis são passadas para o espaço da vista
+ * e testadas contra a caixa de cada cluster, em lotes SIMD de 4 (SSE)
+ * ou 8 (AVX) luzes; cada fatia é uma tarefa do TaskPool.
+ *
+ * O resultado vai para texturas de buffer (GL 3.1, disponíveis nos
+ * shaders 330): os dados das luzes, o intervalo de cada cluster na
+ * lista de índices, e a lista de índices. Os parâmetros da grelha de
+ * cada vista ficam num uniform buffer, ligado pela RenderQueue quando a
+ * vista muda. lighting.frag (ligado como segundo fragment shader aos
+ * programas com cor) encontra o cluster do fragmento e percorre apenas
+ * as luzes desse cluster.
+ */
+class ClusteredLighting {
+public:
+    static constexpr int GRID_X = 16;
+    static constexpr int GRID_Y = 9;
+    static constexpr int GRID_Z = 24;
+    static constexpr int CLUSTERS_PER_VIEW = GRID_X * GRID_Y * GRID_Z;
+    static constexpr int MAX_VIEWS = 16;  // Vistas da RenderQueue (4 bits da chave)
+
+    // Unidades de textura e ponto de ligação do uniform buffer (a unidade 0 é a textura difusa)
+    static constexpr GLuint LIGHT_DATA_UNIT = 1;
+    static constexpr GLuint CLUSTER_RANGES_UNIT = 2;
+    static constexpr GLuint LIGHT_INDICES_UNIT = 3;
+    static constexpr GLuint GRID_BLOCK_BINDING = 0;
+
+    ~ClusteredLighting() { destroy(); }
+
+    /**
+     * @brief Cria os buffers, as texturas de buffer e o uniform buffer das grelhas
+     */
+    bool init();
+
+    /**
+     * @brief Apaga os objetos OpenGL
+     */
+    void destroy();
+
+    /**
+     * @brief Liga as texturas e o bloco ClusterGrid de um programa às unidades desta classe
+     */
+    void setupProgram(GLuint program) const;
+
+    /**
+     * @brief Distribui as luzes pelos clusters das vistas do frame e envia as listas para a GPU
+     * @param lights Luzes da cena (no espaço do mundo)
+     * @param queue Fila com as vistas já registadas
+     * @param viewIds Vistas a iluminar (as restantes não recebem luzes pontuais)
+     * @param pool Threads de trabalho (uma tarefa por fatia de cada vista)
+     */
+    void update(const std::vector<PointLight>& lights, const RenderQueue& queue,
+        const std::vector<uint8_t>& viewIds, TaskPool& pool);
+
+    /**
+     * @brief Liga as texturas e a grelha de uma vista (chamado pela RenderQueue quando a vista muda)
+     */
+    void bindView(uint8_t viewId) const;
+
+    bool isReady() const { return gridBuffer != 0; }
+
+    // Estatísticas do último update()
+    unsigned int getVisibleLights() const { return visibleLights; }   // Soma das luzes visíveis em cada vista
+    unsigned int getIndexCount() const { return indexCount; }         // Entradas nas listas de todos os clusters
+    unsigned int getMaxClusterLights() const { return maxClusterLights; }
+    unsigned int getDroppedIndices() const { return droppedIndices; } // Entradas que não couberam na textura
+
+private:
+    /**
+     * @brief Caixas dos clusters de uma vista no espaço da vista (SoA), recalculadas quando a projeção muda
+     */
+    struct ViewGrid {
+        glm::mat4 projection = glm::mat4(0.0f);
+        bool perspective = true;
+        float nearDepth = 0.0f;      // Distâncias (positivas) dos planos near e far
+        float farDepth = 0.0f;
+        float sliceNear[GRID_Z + 1]; // Profundidade do início de cada fatia
+        std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;  // Uma entrada por cluster
+    };
+
+    /**
+     * @brief Vista iluminada no frame atual e as suas luzes visíveis em lightData
+     */
+    struct FrameView {
+        uint8_t viewId = 0;
+        uint32_t firstLight = 0;
+        uint32_t lightCount = 0;
+        glm::vec4 viewport;            // x, y, largura e altura (os tiles são frações do viewport)
+    };
+
+    /**
+     * @brief Trabalho de uma fatia: luzes que a intersetam e listas dos seus clusters
+     */
+    struct SliceTask {
+        int view = 0;                  // Índice em frameViews
+        int slice = 0;
+        std::vector<float> lightX, lightY, lightZ, lightRadius; // Luzes da fatia (SoA, com preenchimento)
+        std::vector<uint32_t> lightIds;                          // Índice de cada uma nos dados do frame
+        std::vector<uint32_t> indices;                           // Saída: listas dos clusters, seguidas
+        uint32_t counts[GRID_X * GRID_Y];                        // Saída: luzes de cada cluster da fatia
+    };
+
+    /**
+     * @brief Parâmetros de uma vista no bloco ClusterGrid (layout std140)
+     */
+    struct GridBlock {
+        glm::vec4 tileOrigin;    // xy: canto do viewport; zw: tiles por pixel
+        glm::vec4 depthSlicing;  // x: escala, y: deslocamento, z: 1 = fatias logarítmicas
+        GLuint gridSize[4];      // Clusters em x, y, z e o primeiro cluster da vista (x = 0: sem luzes)
+    };
+
+    static void buildGrid(ViewGrid& grid, const glm::mat4& projection);
+    void assignSlice(SliceTask& task) const;
+    void upload();
+
+    ViewGrid grids[MAX_VIEWS];     // Por índice de vista da fila
+    std::vector<FrameView> frameViews;
+    std::vector<SliceTask> tasks;
+    BoundingSpheres lightBounds;   // Esferas de influência no mundo, para o culling por vista
+    std::vector<uint32_t> visible;
+
+    // Dados enviados em cada frame
+    std::vector<glm::vec4> lightData;        // 2 texels por luz: (posição na vista, raio), (cor * intensidade, 0)
+    std::vector<GLuint> clusterRanges;       // 2 valores por cluster: primeiro índice, número de luzes
+    std::vector<GLuint> lightIndices;
+    std::vector<unsigned char> gridBlocks;   // Um GridBlock por vista, com o alinhamento do driver
+
+    GLuint buffers[3] = { 0, 0, 0 };         // Dados das luzes, intervalos dos clusters, índices
+    GLuint textures[3] = { 0, 0, 0 };
+    GLuint gridBuffer = 0;                   // Uniform buffer com um GridBlock por vista
+    GLint blockAlignment = 256;              // Passo entre GridBlocks (múltiplo de GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+    GLint maxTexels = 65536;                 // GL_MAX_TEXTURE_BUFFER_SIZE
+    GLintptr viewBlock[MAX_VIEWS];           // Deslocamento do bloco de cada vista (0 = bloco vazio)
+    GLsizeiptr bufferBytes[4] = { 0, 0, 0, 0 }; // Bytes alocados nos 3 buffers e no uniform buffer (GpuMemory)
+
+    unsigned int visibleLights = 0;
+    unsigned int indexCount = 0;
+    unsigned int maxClusterLights = 0;
+    unsigned int droppedIndices = 0;
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+/***********************************************************************
+ * Implementação do Profiler de CPU
+ ***********************************************************************/
+
+#include "cpuprofiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Evento de início ou fim de uma zona
+     */
+    struct Event {
+        const char* name;
+        uint64_t timestamp;   // Nanossegundos desde CpuProfiler::start()
+        char phase;           // 'B' ou 'E'
+    };
+
+    const size_t CHUNK_EVENTS = 16384;  // Eventos por bloco
+    const size_t MAX_CHUNKS = 512;      // Limite por thread (~8M eventos)
+
+    /**
+     * @brief Buffer de eventos de uma thread (um só escritor: a própria thread)
+     *
+     * Os eventos são guardados em blocos fixos, que nunca são movidos,
+     * para que o exportador possa lê-los enquanto a thread continua a
+     * gravar.
+     */
+    struct ThreadBuffer {
+        uint32_t id = 0;
+        std::string name;
+        std::atomic<Event*> chunks[MAX_CHUNKS];
+        std::atomic<size_t> count{ 0 };
+
+        ThreadBuffer() {
+            for (auto& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+        }
+        ~ThreadBuffer() {
+            for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+        }
+    };
+
+    std::atomic<bool> active{ false };
+    std::chrono::steady_clock::time_point origin;
+
+    // Registo das threads: só é alterado na primeira zona de cada thread
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+    thread_local ThreadBuffer* localBuffer = nullptr;
+
+    ThreadBuffer& threadBuffer() {
+        if (!localBuffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.emplace_back(new ThreadBuffer());
+            localBuffer = registry.back().get();
+            localBuffer->id = static_cast<uint32_t>(registry.size());
+        }
+        return *localBuffer;
+    }
+
+    /**
+     * @brief Escreve uma string JSON com os caracteres especiais escapados
+     */
+    void writeJsonString(FILE* file, const char* text) {
+        std::fputc('"', file);
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') std::fprintf(file, "\\%c", *c);
+            else if (static_cast<unsigned char>(*c) < 0x20) std::fprintf(file, "\\u%04x", *c);
+            else std::fputc(*c, file);
+        }
+        std::fputc('"', file);
+    }
+}
+
+void CpuProfiler::start() {
+    origin = std::chrono::steady_clock::now();
+    active.store(true, std::memory_order_release);
+}
+
+void CpuProfiler::stop() {
+    active.store(false, std::memory_order_release);
+}
+
+bool CpuProfiler::isActive() {
+    return active.load(std::memory_order_relaxed);
+}
+
+void CpuProfiler::setThreadName(const char* name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);  // O exportador lê o nome
+    buffer.name = name;
+}
+
+void CpuProfiler::record(const char* name, char phase) {
+    ThreadBuffer& buffer = threadBuffer();
+    const size_t index = buffer.count.load(std::memory_order_relaxed);
+    const size_t chunkIndex = index / CHUNK_EVENTS;
+    if (chunkIndex >= MAX_CHUNKS) return;  // Buffer cheio: o evento perde-se
+
+    Event* chunk = buffer.chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Event[CHUNK_EVENTS];
+        buffer.chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - origin;
+    Event& event = chunk[index % CHUNK_EVENTS];
+    event.name = name;
+    event.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    event.phase = phase;
+
+    // Publica o evento: o exportador só lê até count
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+size_t CpuProfiler::getEventCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t total = 0;
+    for (const auto& buffer : registry) {
+        total += buffer->count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+bool CpuProfiler::writeChromeTrace(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    bool first = true;
+    for (const auto& buffer : registry) {
+        // Metadados: nome da thread
+        if (!buffer->name.empty()) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",\n", buffer->id);
+            writeJsonString(file, buffer->name.c_str());
+            std::fprintf(file, "}}");
+            first = false;
+        }
+
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const Event* chunk = buffer->chunks[i / CHUNK_EVENTS].load(std::memory_order_acquire);
+            const Event& event = chunk[i % CHUNK_EVENTS];
+
+            // ts em microssegundos, com a precisão dos nanossegundos
+            std::fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            writeJsonString(file, event.name);
+            std::fprintf(file, ",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":1,\"tid\":%u}",
+                event.phase,
+                static_cast<unsigned long long>(event.timestamp / 1000),
+                static_cast<unsigned long long>(event.timestamp % 1000),
+                buffer->id);
+            first = false;
+        }
+    }
+
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: timestamps em nanossegundos
+ * - string: caminho do ficheiro de trace
+ */
+#include <cstdint>
+#include <string>
+
+/**
+ * Interruptor de compilação: com P3D_PROFILE a 0 as macros PROFILE_* não
+ * geram código nenhum. Por omissão as zonas são compiladas e só gravam
+ * eventos enquanto a captura estiver ativa (--trace).
+ */
+#ifndef P3D_PROFILE
+#define P3D_PROFILE 1
+#endif
+
+/**
+ * @brief Profiler de CPU por zonas, em todas as threads
+ *
+ * Cada zona grava um evento de início e outro de fim, com o tempo em
+ * nanossegundos desde start(), no buffer da thread que a executa. Cada
+ * thread escreve apenas no seu buffer (registado uma única vez, na
+ * primeira zona da thread), por isso a gravação não usa locks: o número
+ * de eventos é publicado com uma escrita atómica e o exportador lê só
+ * os eventos já publicados.
+ *
+ * O resultado é exportado no formato Chrome Trace Event (JSON), que pode
+ * ser aberto em chrome://tracing ou no Perfetto.
+ */
+class CpuProfiler {
+public:
+    /**
+     * @brief Começa a gravar eventos (o tempo 0 do trace é este instante)
+     */
+    static void start();
+
+    /**
+     * @brief Deixa de gravar eventos (os já gravados são mantidos)
+     */
+    static void stop();
+
+    static bool isActive();
+
+    /**
+     * @brief Dá um nome à thread atual no trace
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief Grava um evento de início ('B') ou fim ('E') de zona na thread atual
+     * @param name Nome da zona (literal: só o ponteiro é guardado)
+     */
+    static void record(const char* name, char phase);
+
+    /**
+     * @brief Escreve todos os eventos gravados no formato Chrome Trace Event
+     * @return false se o ficheiro não pôde ser criado
+     */
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * @brief Número total de eventos gravados em todas as threads
+     */
+    static size_t getEventCount();
+};
+
+/**
+ * @brief Zona delimitada pelo tempo de vida do objeto (usar através de PROFILE_ZONE)
+ */
+class CpuZone {
+public:
+    explicit CpuZone(const char* zoneName) : name(CpuProfiler::isActive() ? zoneName : nullptr) {
+        if (name) CpuProfiler::record(name, 'B');
+    }
+    ~CpuZone() {
+        if (name) CpuProfiler::record(name, 'E');
+    }
+
+    CpuZone(const CpuZone&) = delete;
+    CpuZone& operator=(const CpuZone&) = delete;
+
+private:
+    const char* name;  // nullptr: a captura não estava ativa quando a zona começou
+};
+
+#if P3D_PROFILE
+#define P3D_PROFILE_CONCAT_(a, b) a##b
+#define P3D_PROFILE_CONCAT(a, b) P3D_PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) CpuZone P3D_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_THREAD(name) CpuProfiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
\ No newline at end of file
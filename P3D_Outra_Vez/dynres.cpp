@@ -0,0 +1,103 @@
+/***********************************************************************
+ * Implementação da Resolução Dinâmica
+ ***********************************************************************/
+
+#include "dynres.h"
+#include <algorithm>
+#include <cmath>
+
+// Parâmetros do controlador
+static const double SMOOTHING = 0.1;        // Peso do frame atual na média
+static const double HEADROOM = 0.85;        // Abaixo de 85% do orçamento a escala sobe
+static const float MAX_STEP = 0.05f;        // Variação máxima da escala por frame
+
+bool DynamicResolution::init(GLsizei width, GLsizei height, double budget, float minimumScale) {
+    destroy();
+    budgetMs = budget;
+    minScale = std::min(std::max(minimumScale, 0.1f), 1.0f);
+    smoothedMs = budget;
+
+    if (!target.create(width, height)) {
+        return false;
+    }
+
+    glGenQueries(RING_SIZE, timerQueries);
+    for (bool& p : pending) p = false;
+    current = 0;
+
+    applyScale(1.0f);
+    return true;
+}
+
+void DynamicResolution::destroy() {
+    if (timerQueries[0]) {
+        glDeleteQueries(RING_SIZE, timerQueries);
+        for (GLuint& q : timerQueries) q = 0;
+    }
+    target.destroy();
+}
+
+void DynamicResolution::beginFrame() {
+    timing = false;
+    if (!timerQueries[0]) return;
+
+    // Lê o resultado antigo desta entrada; se ainda não chegou, não mede este frame
+    if (pending[current]) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(timerQueries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(timerQueries[current], GL_QUERY_RESULT, &elapsed);
+        gpuMs = elapsed / 1.0e6;
+        pending[current] = false;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, timerQueries[current]);
+    timing = true;
+}
+
+void DynamicResolution::endFrame(double cpuMs) {
+    if (timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending[current] = true;
+        current = (current + 1) % RING_SIZE;
+        timing = false;
+    }
+
+    // O frame está limitado pelo processador mais lento
+    const double frameMs = std::max(cpuMs, gpuMs);
+    smoothedMs += (frameMs - smoothedMs) * SMOOTHING;
+
+    if (!enabled || smoothedMs <= 0.0) return;
+
+    // Dentro da zona morta [HEADROOM, 1] x orçamento a escala mantém-se
+    const double ratio = smoothedMs / budgetMs;
+    if (ratio <= 1.0 && ratio >= HEADROOM) return;
+
+    // O custo cresce com a área: corrige pela raiz quadrada do rácio
+    const float desired = scale * static_cast<float>(std::sqrt(1.0 / ratio));
+    const float step = std::min(std::max(desired - scale, -MAX_STEP), MAX_STEP);
+    applyScale(scale + step);
+}
+
+void DynamicResolution::setEnabled(bool value) {
+    enabled = value;
+    if (!enabled) {
+        applyScale(1.0f);
+    }
+}
+
+void DynamicResolution::applyScale(float newScale) {
+    scale = std::min(std::max(newScale, minScale), 1.0f);
+
+    // Dimensões pares evitam desalinhamentos de meio pixel na ampliação
+    renderWidth = std::max<GLsizei>(2, static_cast<GLsizei>(target.getWidth() * scale) & ~1);
+    renderHeight = std::max<GLsizei>(2, static_cast<GLsizei>(target.getHeight() * scale) & ~1);
+}
+
+void DynamicResolution::present(GLuint dstFramebuffer) const {
+    target.blitRegionTo(renderWidth, renderHeight, dstFramebuffer,
+        0, 0, target.getWidth(), target.getHeight(),
+        (renderWidth == target.getWidth()) ? GL_NEAREST : GL_LINEAR);
+}
\ No newline at end of file
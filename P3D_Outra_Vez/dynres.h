@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - GL/glew: queries de tempo da GPU
+ * - rendertarget: alvo fora do ecrã onde a vista principal é desenhada
+ */
+#include <GL/glew.h>
+#include "rendertarget.h"
+
+/**
+ * @brief Resolução dinâmica da vista principal
+ *
+ * A vista principal é desenhada num alvo fora do ecrã, com as dimensões
+ * da janela multiplicadas por uma escala. No fim do frame, a região
+ * usada é ampliada para a janela com filtragem bilinear.
+ *
+ * O alvo é criado uma única vez com a resolução máxima; baixar a escala
+ * apenas reduz o viewport, sem realocar memória.
+ *
+ * A escala é ajustada em cada frame comparando o tempo do frame (o
+ * maior entre o tempo de CPU e o tempo de GPU medido por timer queries)
+ * com o orçamento configurado. O custo de fragmentos é proporcional à
+ * área, por isso a escala corrige-se pela raiz quadrada do rácio
+ * orçamento/tempo, com uma zona morta e um passo máximo por frame para
+ * evitar oscilações visíveis.
+ */
+class DynamicResolution {
+public:
+    ~DynamicResolution() { destroy(); }
+
+    /**
+     * @brief Cria o alvo e as queries
+     * @param width, height Resolução máxima (a da janela)
+     * @param budgetMs Tempo por frame pretendido, em milissegundos
+     * @param minScale Escala mínima permitida (0..1]
+     */
+    bool init(GLsizei width, GLsizei height, double budgetMs, float minScale = 0.5f);
+
+    /**
+     * @brief Liberta o alvo e as queries
+     */
+    void destroy();
+
+    /**
+     * @brief Começa a medição do tempo de GPU do frame
+     */
+    void beginFrame();
+
+    /**
+     * @brief Termina a medição e atualiza a escala para o próximo frame
+     * @param cpuMs Tempo de CPU gasto neste frame, em milissegundos
+     */
+    void endFrame(double cpuMs);
+
+    /**
+     * @brief Amplia a região desenhada para a janela
+     * @param dstFramebuffer Framebuffer de destino (0 = janela)
+     */
+    void present(GLuint dstFramebuffer = 0) const;
+
+    /**
+     * @brief Ativa ou desativa o ajuste (desativado, a escala fica em 1)
+     */
+    void setEnabled(bool value);
+    bool isEnabled() const { return enabled; }
+
+    void setBudget(double ms) { budgetMs = ms; }
+    double getBudget() const { return budgetMs; }
+
+    float getScale() const { return scale; }
+    GLsizei getRenderWidth() const { return renderWidth; }
+    GLsizei getRenderHeight() const { return renderHeight; }
+    double getLastFrameMs() const { return smoothedMs; }
+    double getLastGpuMs() const { return gpuMs; }
+
+    GLuint getFramebuffer() const { return target.getFramebuffer(); }
+
+private:
+    void applyScale(float newScale);
+
+    static const int RING_SIZE = 3;        // Frames de latência até à leitura do tempo de GPU
+
+    RenderTarget target;                   // Alvo com a resolução máxima
+    GLuint timerQueries[RING_SIZE] = {};
+    bool pending[RING_SIZE] = {};
+    int current = 0;
+    bool timing = false;                   // beginFrame() iniciou uma query
+
+    bool enabled = true;
+    double budgetMs = 16.6;
+    float minScale = 0.5f;
+    float scale = 1.0f;
+    GLsizei renderWidth = 0;
+    GLsizei renderHeight = 0;
+
+    double gpuMs = 0.0;                    // Último tempo de GPU lido
+    double smoothedMs = 0.0;               // Média exponencial do tempo do frame
+};
\ No newline at end of file
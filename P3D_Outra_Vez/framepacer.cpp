@@ -0,0 +1,165 @@
+/***********************************************************************
+ * Implementação do Controlo do Ritmo dos Frames
+ ***********************************************************************/
+
+#ifdef _WIN32
+// Aumenta a resolução do Sleep do Windows para 1 ms
+#pragma comment(lib, "winmm.lib")
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+#include "framepacer.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Margem final do limitador feita em espera ativa
+static const double SPIN_MARGIN = 0.002;
+
+/**
+ * @brief Tempo monotónico em segundos
+ */
+static double pacerClock() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Percentil (nearest-rank) de uma amostra ordenada
+ */
+static float percentile(const std::vector<float>& sorted, double p) {
+    if (sorted.empty()) return 0.0f;
+    const size_t rank = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+bool FramePacer::parseMode(const std::string& name, PacingMode& result) {
+    for (PacingMode candidate : { PACING_VSYNC, PACING_ADAPTIVE, PACING_UNCAPPED, PACING_FIXED }) {
+        if (name == modeName(candidate)) {
+            result = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* FramePacer::modeName(PacingMode value) {
+    switch (value) {
+    case PACING_VSYNC: return "vsync";
+    case PACING_ADAPTIVE: return "adaptive";
+    case PACING_UNCAPPED: return "uncapped";
+    case PACING_FIXED: return "fixed";
+    }
+    return "?";
+}
+
+void FramePacer::init(PacingMode newMode, double targetFps, double refreshHz) {
+    mode = newMode;
+    frameInterval = (targetFps > 0.0) ? 1.0 / targetFps : 0.0;
+    const double refreshInterval = (refreshHz > 0.0) ? 1.0 / refreshHz : 0.0;
+
+    // O vsync adaptativo depende de uma extensão do sistema de janelas
+    if (mode == PACING_ADAPTIVE &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        mode = PACING_VSYNC;
+    }
+
+    switch (mode) {
+    case PACING_VSYNC:
+        glfwSwapInterval(1);
+        expectedInterval = refreshInterval;
+        break;
+    case PACING_ADAPTIVE:
+        glfwSwapInterval(-1);
+        expectedInterval = refreshInterval;
+        break;
+    case PACING_UNCAPPED:
+        glfwSwapInterval(0);
+        expectedInterval = 0.0;
+        break;
+    case PACING_FIXED:
+        glfwSwapInterval(0);
+        expectedInterval = frameInterval;
+        break;
+    }
+
+#ifdef _WIN32
+    if (mode == PACING_FIXED) {
+        timeBeginPeriod(1);
+    }
+#endif
+
+    cpuMs.clear();
+    presentMs.clear();
+    cpuMs.reserve(1 << 16);
+    presentMs.reserve(1 << 16);
+    droppedFrames = 0;
+    lastPresent = 0.0;
+    deadline = pacerClock();
+}
+
+void FramePacer::beginFrame() {
+    frameStart = pacerClock();
+}
+
+void FramePacer::waitForPresent() {
+    const double now = pacerClock();
+    cpuMs.push_back(static_cast<float>((now - frameStart) * 1000.0));
+
+    if (mode != PACING_FIXED || frameInterval <= 0.0) return;
+
+    // Prazos absolutos: o erro de um frame não se acumula nos seguintes
+    deadline += frameInterval;
+    if (deadline < now) {
+        deadline = now; // Atrasado: recomeça a partir de agora
+        return;
+    }
+
+    const double sleepTime = deadline - now - SPIN_MARGIN;
+    if (sleepTime > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+    }
+    while (pacerClock() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::endFrame() {
+    const double now = pacerClock();
+    if (lastPresent > 0.0) {
+        const double interval = now - lastPresent;
+        presentMs.push_back(static_cast<float>(interval * 1000.0));
+        if (expectedInterval > 0.0 && interval > expectedInterval * 1.5) {
+            ++droppedFrames;
+        }
+    }
+    lastPresent = now;
+}
+
+void FramePacer::report(std::ostream& out) const {
+    std::vector<float> cpu = cpuMs;
+    std::vector<float> present = presentMs;
+    std::sort(cpu.begin(), cpu.end());
+    std::sort(present.begin(), present.end());
+
+    out << "Ritmo dos frames (" << modeName(mode) << "), " << present.size() << " frames" << std::endl;
+    out << "  CPU (ms):         p50 " << percentile(cpu, 50) << "  p95 " << percentile(cpu, 95)
+        << "  p99 " << percentile(cpu, 99) << std::endl;
+    out << "  Apresentacao (ms): p50 " << percentile(present, 50) << "  p95 " << percentile(present, 95)
+        << "  p99 " << percentile(present, 99) << std::endl;
+    if (expectedInterval > 0.0) {
+        out << "  Frames perdidos: " << droppedFrames << " (intervalo > " << expectedInterval * 1500.0 << " ms)" << std::endl;
+    }
+}
+
+void FramePacer::shutdown() {
+#ifdef _WIN32
+    if (mode == PACING_FIXED) {
+        timeEndPeriod(1);
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - vector: tempos registados por frame
+ * - string: nome do modo
+ * - ostream: relatório final
+ */
+#include <vector>
+#include <string>
+#include <ostream>
+
+/**
+ * @brief Modo de ritmo dos frames
+ */
+enum PacingMode {
+    PACING_VSYNC,     // Sincronizado com o ecrã (swap interval 1)
+    PACING_ADAPTIVE,  // Vsync que rasga quando o frame se atrasa (swap interval -1), se suportado
+    PACING_UNCAPPED,  // Sem limite (swap interval 0): para benchmarks
+    PACING_FIXED      // Limite de FPS por software: sleep seguido de espera ativa
+};
+
+/**
+ * @brief Controlo do ritmo dos frames e estatísticas de apresentação
+ *
+ * Em cada frame regista o tempo de CPU (do início do frame até ao
+ * pedido de apresentação) e o intervalo entre apresentações sucessivas
+ * (depois de glfwSwapBuffers retornar). No fim, reporta os percentis
+ * p50/p95/p99 e o número de frames perdidos, isto é, intervalos mais
+ * longos do que 1,5 vezes o intervalo esperado.
+ *
+ * No modo fixo o limitador dorme até perto do prazo e faz o resto em
+ * espera ativa, porque a resolução do sleep do sistema (1 ms ou pior)
+ * não é suficiente para um ritmo regular.
+ */
+class FramePacer {
+public:
+    /**
+     * @brief Configura o modo e aplica o swap interval ao contexto atual
+     * @param mode Modo de ritmo
+     * @param targetFps FPS pretendidos no modo fixo
+     * @param refreshHz Frequência do ecrã (define o intervalo esperado com vsync)
+     */
+    void init(PacingMode mode, double targetFps, double refreshHz);
+
+    /**
+     * @brief Marca o início do trabalho do frame
+     */
+    void beginFrame();
+
+    /**
+     * @brief Termina o trabalho de CPU do frame; no modo fixo espera pelo prazo
+     *
+     * Deve ser chamado imediatamente antes de glfwSwapBuffers.
+     */
+    void waitForPresent();
+
+    /**
+     * @brief Regista o intervalo de apresentação (depois de glfwSwapBuffers)
+     */
+    void endFrame();
+
+    /**
+     * @brief Escreve o resumo das estatísticas
+     */
+    void report(std::ostream& out) const;
+
+    /**
+     * @brief Repõe a resolução do temporizador do sistema
+     */
+    void shutdown();
+
+    PacingMode getMode() const { return mode; }
+
+    /**
+     * @brief Converte o nome de um modo ("vsync", "adaptive", "uncapped", "fixed")
+     * @return false se o nome não for conhecido
+     */
+    static bool parseMode(const std::string& name, PacingMode& mode);
+    static const char* modeName(PacingMode mode);
+
+private:
+    PacingMode mode = PACING_VSYNC;
+    double expectedInterval = 0.0;   // Intervalo esperado entre apresentações (s), 0 = sem referência
+    double frameInterval = 0.0;      // Intervalo do limitador no modo fixo (s)
+
+    double frameStart = 0.0;         // Início do frame atual
+    double deadline = 0.0;           // Próximo instante de apresentação no modo fixo
+    double lastPresent = 0.0;        // Fim da última apresentação (0 = nenhuma)
+
+    std::vector<float> cpuMs;        // Tempo de CPU de cada frame
+    std::vector<float> presentMs;    // Intervalo entre apresentações
+    unsigned int droppedFrames = 0;
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+/***********************************************************************
+ * Implementação do Frustum Culling
+ *
+ * Extrai os planos do frustum de cada câmera e testa as esferas
+ * envolventes dos objetos em lotes SIMD, para que apenas os objetos
+ * visíveis sejam submetidos para a fila de renderização.
+ ***********************************************************************/
+
+#include "frustum.h"
+#include <immintrin.h>
+#include <algorithm>
+
+/**
+ * @brief Extração dos planos pelo método de Gribb/Hartmann
+ *
+ * Com M = projeção * visualização, um ponto está dentro do frustum quando
+ * -w <= x, y, z <= w no clip space. Cada desigualdade corresponde a um
+ * plano obtido somando/subtraindo linhas de M à quarta linha.
+ */
+Frustum Frustum::fromViewProjection(const glm::mat4& m) {
+    // As matrizes glm são column-major: m[coluna][linha]
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0; // Esquerdo
+    frustum.planes[1] = row3 - row0; // Direito
+    frustum.planes[2] = row3 + row1; // Inferior
+    frustum.planes[3] = row3 - row1; // Superior
+    frustum.planes[4] = row3 + row2; // Perto
+    frustum.planes[5] = row3 - row2; // Longe
+
+    // Normaliza para que a distância ao plano seja em unidades do mundo
+    for (glm::vec4& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BoundingSpheres::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+    count = 0;
+}
+
+void BoundingSpheres::add(const glm::vec3& center, float r) {
+    // Substitui o preenchimento (se existir) pela nova esfera
+    centerX.resize(count);
+    centerY.resize(count);
+    centerZ.resize(count);
+    radius.resize(count);
+
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(r);
+    ++count;
+
+    // Completa até um múltiplo de 8 com esferas que nunca são visíveis
+    const size_t padded = (count + 7) & ~size_t(7);
+    centerX.resize(padded, 0.0f);
+    centerY.resize(padded, 0.0f);
+    centerZ.resize(padded, 0.0f);
+    radius.resize(padded, -1.0e30f);
+}
+
+void cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres,
+    std::vector<uint32_t>& visible, CullStats& stats) {
+    cullSpheres(frustum, spheres, 0, spheres.count, visible, stats);
+}
+
+void cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, size_t begin, size_t end,
+    std::vector<uint32_t>& visible, CullStats& stats) {
+    visible.clear();
+    end = std::min(end, spheres.count);
+
+    // O padding garante lotes completos até ao próximo múltiplo de 8
+    const size_t padded = std::min(spheres.radius.size(), (end + 7) & ~size_t(7));
+
+#if defined(__AVX__)
+    // 8 esferas por iteração
+    for (size_t i = begin; i < padded; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&spheres.centerX[i]);
+        const __m256 y = _mm256_loadu_ps(&spheres.centerY[i]);
+        const __m256 z = _mm256_loadu_ps(&spheres.centerZ[i]);
+        const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.radius[i]));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const glm::vec4& plane : frustum.planes) {
+            __m256 d = _mm256_mul_ps(x, _mm256_set1_ps(plane.x));
+            d = _mm256_add_ps(d, _mm256_mul_ps(y, _mm256_set1_ps(plane.y)));
+            d = _mm256_add_ps(d, _mm256_mul_ps(z, _mm256_set1_ps(plane.z)));
+            d = _mm256_add_ps(d, _mm256_set1_ps(plane.w));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GE_OQ));
+        }
+
+        const int mask = _mm256_movemask_ps(inside);
+        for (int bit = 0; bit < 8; ++bit) {
+            if ((mask & (1 << bit)) && i + bit < end) {
+                visible.push_back(static_cast<uint32_t>(i + bit));
+            }
+        }
+    }
+#else
+    // 4 esferas por iteração
+    for (size_t i = begin; i < padded; i += 4) {
+        const __m128 x = _mm_loadu_ps(&spheres.centerX[i]);
+        const __m128 y = _mm_loadu_ps(&spheres.centerY[i]);
+        const __m128 z = _mm_loadu_ps(&spheres.centerZ[i]);
+        const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const glm::vec4& plane : frustum.planes) {
+            __m128 d = _mm_mul_ps(x, _mm_set1_ps(plane.x));
+            d = _mm_add_ps(d, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+            d = _mm_add_ps(d, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+            d = _mm_add_ps(d, _mm_set1_ps(plane.w));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (int bit = 0; bit < 4; ++bit) {
+            if ((mask & (1 << bit)) && i + bit < end) {
+                visible.push_back(static_cast<uint32_t>(i + bit));
+            }
+        }
+    }
+#endif
+
+    stats.visible = static_cast<unsigned int>(visible.size());
+    stats.culled = static_cast<unsigned int>((end > begin ? end - begin : 0) - visible.size());
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: índices dos objetos visíveis
+ * - vector: armazenamento SoA das esferas envolventes
+ * - glm: planos e matrizes da câmera
+ */
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Contadores de culling de uma vista
+ */
+struct CullStats {
+    unsigned int visible = 0;  // Objetos que intersetam o frustum
+    unsigned int culled = 0;   // Objetos descartados antes de chegar à fila
+};
+
+/**
+ * @brief Frustum de visualização representado por seis planos
+ *
+ * Cada plano é guardado como (a, b, c, d) normalizado, com a normal a
+ * apontar para o interior: um ponto p está dentro se dot(n, p) + d >= 0.
+ */
+struct Frustum {
+    glm::vec4 planes[6]; // Esquerdo, direito, inferior, superior, perto, longe
+
+    /**
+     * @brief Extrai os planos a partir da matriz projeção * visualização
+     * @param viewProjection Matriz que leva coordenadas do mundo ao clip space
+     */
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Teste escalar de uma única esfera
+     */
+    bool intersectsSphere(const glm::vec3& center, float radius) const;
+};
+
+/**
+ * @brief Esferas envolventes em formato structure-of-arrays
+ *
+ * Os centros e raios ficam em vetores separados e contíguos para que o
+ * teste contra o frustum carregue 4 (SSE) ou 8 (AVX) esferas por
+ * instrução. O tamanho dos vetores é arredondado para múltiplos de 8 com
+ * esferas de raio negativo, que nunca são visíveis.
+ */
+struct BoundingSpheres {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+    size_t count = 0;          // Número de esferas válidas (sem o preenchimento)
+
+    void clear();
+    void add(const glm::vec3& center, float r);
+};
+
+/**
+ * @brief Testa todas as esferas contra o frustum
+ *
+ * Usa AVX quando o compilador o ativa (/arch:AVX), SSE caso contrário.
+ *
+ * @param frustum Frustum da vista
+ * @param spheres Esferas envolventes dos objetos
+ * @param visible Saída: índices das esferas que intersetam o frustum
+ * @param stats Saída: contadores de visíveis/descartados da vista
+ */
+void cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres,
+    std::vector<uint32_t>& visible, CullStats& stats);
+
+/**
+ * @brief Testa apenas as esferas [begin, end) contra o frustum
+ *
+ * Permite repartir o culling de muitos objetos entre várias threads.
+ *
+ * @param begin Primeiro índice (múltiplo de 8)
+ * @param end Índice final (exclusivo; limitado ao número de esferas)
+ */
+void cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, size_t begin, size_t end,
+    std::vector<uint32_t>& visible, CullStats& stats);
@@ -0,0 +1,57 @@
+/***********************************************************************
+ * Deteção das Capacidades do Contexto OpenGL
+ *
+ * Identifica a versão do contexto e as extensões relevantes para os
+ * caminhos de renderização opcionais.
+ ***********************************************************************/
+
+#include "glcaps.h"
+#include <iostream>
+
+/**
+ * @brief Lê uma string do driver, tolerando ponteiros nulos
+ */
+static std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+GLCapabilities probeGLCapabilities() {
+    GLCapabilities caps;
+
+    glGetIntegerv(GL_MAJOR_VERSION, &caps.major);
+    glGetIntegerv(GL_MINOR_VERSION, &caps.minor);
+    caps.vendor = glString(GL_VENDOR);
+    caps.renderer = glString(GL_RENDERER);
+    caps.version = glString(GL_VERSION);
+
+    // Funcionalidades do núcleo 4.3/4.4 ou das extensões equivalentes
+    caps.bufferStorage = caps.atLeast(4, 4) || GLEW_ARB_buffer_storage;
+    caps.shaderStorageBuffer = caps.atLeast(4, 3) || GLEW_ARB_shader_storage_buffer_object;
+    caps.copyImage = caps.atLeast(4, 3) || glewIsSupported("GL_ARB_copy_image");
+    caps.multiDrawIndirect = caps.atLeast(4, 3) || GLEW_ARB_multi_draw_indirect;
+    caps.shaderDrawParameters = GLEW_ARB_shader_draw_parameters; // shader_mdi.vert usa gl_DrawIDARB
+    caps.pipelineStatistics = caps.atLeast(4, 6) || GLEW_ARB_pipeline_statistics_query;
+    caps.bindlessTexture = GLEW_ARB_bindless_texture;
+    caps.parallelShaderCompile = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+
+    // Alguns drivers expõem a extensão mas não oferecem nenhum formato de binário
+    GLint binaryFormats = 0;
+    if (caps.atLeast(4, 1) || GLEW_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+    }
+    caps.programBinary = binaryFormats > 0;
+
+    return caps;
+}
+
+void printGLCapabilities(const GLCapabilities& caps) {
+    std::cout << "OpenGL " << caps.major << "." << caps.minor
+        << " (" << caps.version << ")" << std::endl;
+    std::cout << "  Renderer: " << caps.renderer << " [" << caps.vendor << "]" << std::endl;
+    std::cout << "  Multi-draw indireto: " << (caps.canMultiDraw() ? "sim" : "nao") << std::endl;
+    std::cout << "  Texturas bindless: " << (caps.bindlessTexture ? "sim" : "nao") << std::endl;
+    std::cout << "  Compilacao paralela de shaders: " << (caps.parallelShaderCompile ? "sim" : "nao") << std::endl;
+    std::cout << "  Cache de binarios de programas: " << (caps.programBinary ? "sim" : "nao") << std::endl;
+    std::cout << "  Estatisticas do pipeline: " << (caps.pipelineStatistics ? "sim" : "nao") << std::endl;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string: para guardar as strings de identificação do driver
+ * - GL/glew: para consultar versões e extensões disponíveis
+ */
+#include <string>
+#include <GL/glew.h>
+
+/**
+ * @brief Capacidades do contexto OpenGL atual
+ *
+ * Preenchida uma única vez depois de glewInit(). Os subsistemas que usam
+ * funcionalidades opcionais (multi-draw indireto, buffers persistentes,
+ * ...) consultam esta estrutura para decidir entre o caminho rápido e o
+ * caminho de recurso.
+ */
+struct GLCapabilities {
+    int major = 0;                    // Versão do contexto criado
+    int minor = 0;
+    std::string vendor;               // GL_VENDOR
+    std::string renderer;             // GL_RENDERER
+    std::string version;              // GL_VERSION
+
+    bool bufferStorage = false;       // glBufferStorage (GL 4.4 / ARB_buffer_storage)
+    bool shaderStorageBuffer = false; // SSBOs (GL 4.3)
+    bool copyImage = false;           // glCopyImageSubData (GL 4.3)
+    bool multiDrawIndirect = false;   // glMultiDrawElementsIndirect (GL 4.3)
+    bool shaderDrawParameters = false;// gl_DrawIDARB no shader (ARB_shader_draw_parameters)
+    bool pipelineStatistics = false;  // Queries de invocações dos shaders (GL 4.6 / ARB_pipeline_statistics_query)
+    bool bindlessTexture = false;     // Handles de textura de 64 bits (ARB_bindless_texture)
+    bool parallelShaderCompile = false;// Compilação em threads do driver (KHR/ARB_parallel_shader_compile)
+    bool programBinary = false;       // glGetProgramBinary com pelo menos um formato (GL 4.1 / ARB_get_program_binary)
+
+    /**
+     * @brief Verifica se o contexto é pelo menos da versão indicada
+     */
+    bool atLeast(int maj, int min) const {
+        return major > maj || (major == maj && minor >= min);
+    }
+
+    /**
+     * @brief Indica se o caminho de submissão por multi-draw indireto pode ser usado
+     */
+    bool canMultiDraw() const {
+        return atLeast(4, 3) && multiDrawIndirect && shaderDrawParameters && shaderStorageBuffer && copyImage;
+    }
+};
+
+/**
+ * @brief Consulta o contexto OpenGL atual e preenche as capacidades
+ *
+ * Deve ser chamada com um contexto ativo e depois de glewInit().
+ */
+GLCapabilities probeGLCapabilities();
+
+/**
+ * @brief Imprime um resumo das capacidades na consola
+ */
+void printGLCapabilities(const GLCapabilities& caps);
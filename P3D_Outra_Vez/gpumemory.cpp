@@ -0,0 +1,19 @@
+/***********************************************************************
+ * Implementação dos Contadores de Memória de GPU
+ ***********************************************************************/
+
+#include "gpumemory.h"
+
+long long GpuMemory::textureBytes = 0;
+long long GpuMemory::bufferBytes = 0;
+
+long long GpuMemory::imageBytes(GLsizei width, GLsizei height, GLsizei layers, int bytesPerTexel, GLsizei levels) {
+    long long total = 0;
+    for (GLsizei level = 0; levels == 0 || level < levels; ++level) {
+        total += static_cast<long long>(width) * height * layers * bytesPerTexel;
+        if (width == 1 && height == 1) break;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return total;
+}
\ No newline at end of file
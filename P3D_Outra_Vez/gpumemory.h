@@ -0,0 +1,45 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - GL/glew: tipos das dimensões das texturas
+ */
+#include <GL/glew.h>
+
+/**
+ * @brief Contadores da memória de GPU alocada pela aplicação
+ *
+ * Cada ponto do código que cria ou liberta uma textura, um renderbuffer
+ * ou um buffer soma (ou subtrai) o número de bytes pedido ao driver.
+ * Os valores são uma estimativa do que está residente: não incluem o
+ * alinhamento nem a compressão feitos pelo driver. Apenas a thread do
+ * OpenGL altera os contadores.
+ */
+class GpuMemory {
+public:
+    /**
+     * @brief Regista bytes de texturas/renderbuffers criados (positivo) ou libertados (negativo)
+     */
+    static void addTexture(long long bytes) { textureBytes += bytes; }
+
+    /**
+     * @brief Regista bytes de buffers criados (positivo) ou libertados (negativo)
+     */
+    static void addBuffer(long long bytes) { bufferBytes += bytes; }
+
+    static long long getTextureBytes() { return textureBytes; }
+    static long long getBufferBytes() { return bufferBytes; }
+
+    /**
+     * @brief Bytes de uma imagem com todos os níveis de mipmap pedidos
+     * @param width, height Dimensões do nível 0
+     * @param layers Número de camadas (1 para texturas 2D)
+     * @param bytesPerTexel Bytes de cada texel
+     * @param levels Número de níveis (0 = cadeia completa até 1x1)
+     */
+    static long long imageBytes(GLsizei width, GLsizei height, GLsizei layers, int bytesPerTexel, GLsizei levels = 1);
+
+private:
+    static long long textureBytes;
+    static long long bufferBytes;
+};
\ No newline at end of file
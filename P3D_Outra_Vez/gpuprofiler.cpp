@@ -0,0 +1,189 @@
+/***********************************************************************
+ * Implementação do Profiler de GPU
+ ***********************************************************************/
+
+#include "gpuprofiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+void GpuProfiler::init() {
+    destroy();
+    for (Frame& frame : frames) {
+        glGenQueries(MAX_SCOPES * 2, frame.queries);
+        frame.records.reserve(MAX_SCOPES);
+        frame.pending = false;
+    }
+    current = 0;
+}
+
+void GpuProfiler::destroy() {
+    for (Frame& frame : frames) {
+        if (frame.queries[0]) {
+            glDeleteQueries(MAX_SCOPES * 2, frame.queries);
+            std::fill(frame.queries, frame.queries + MAX_SCOPES * 2, 0u);
+        }
+        frame.records.clear();
+        frame.pending = false;
+    }
+    measuring = false;
+    stack.clear();
+}
+
+void GpuProfiler::beginFrame() {
+    measuring = false;
+    stack.clear();
+
+    Frame& frame = frames[current];
+    if (!frame.queries[0] || !enabled) return;
+
+    // Lê o frame emitido há RING_SIZE frames; se ainda não terminou, este frame não é medido
+    if (frame.pending) {
+        // Os timestamps terminam pela ordem de emissão: basta testar o último
+        GLuint available = 0;
+        glGetQueryObjectuiv(frame.queries[frame.lastQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            ++skippedFrames;
+            return;
+        }
+        collect(frame);
+    }
+
+    frame.records.clear();
+    measuring = true;
+}
+
+void GpuProfiler::endFrame() {
+    if (!measuring) return;
+
+    while (!stack.empty()) {
+        endScope();
+    }
+
+    Frame& frame = frames[current];
+    frame.pending = !frame.records.empty();
+    current = (current + 1) % RING_SIZE;
+    measuring = false;
+}
+
+void GpuProfiler::beginScope(const char* name) {
+    if (!measuring) return;
+
+    Frame& frame = frames[current];
+    if (frame.records.size() >= MAX_SCOPES) {
+        stack.push_back(-1);  // Sem queries livres: o scope é ignorado
+        return;
+    }
+
+    // O pai é o scope aberto mais próximo que não foi descartado
+    int parent = -1;
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        if (*it >= 0) { parent = *it; break; }
+    }
+
+    const int index = static_cast<int>(frame.records.size());
+    frame.records.push_back({ name, parent, parent >= 0 ? frame.records[parent].depth + 1 : 0 });
+    glQueryCounter(frame.queries[index * 2], GL_TIMESTAMP);
+    stack.push_back(index);
+}
+
+void GpuProfiler::endScope() {
+    if (!measuring || stack.empty()) return;
+
+    const int index = stack.back();
+    stack.pop_back();
+    if (index < 0) return;
+
+    Frame& frame = frames[current];
+    glQueryCounter(frame.queries[index * 2 + 1], GL_TIMESTAMP);
+    frame.lastQuery = index * 2 + 1;
+}
+
+GpuScopeStats& GpuProfiler::statsFor(const std::string& path, const char* name, int depth) {
+    for (GpuScopeStats& s : scopes) {
+        if (s.path == path) return s;
+    }
+    GpuScopeStats s;
+    s.path = path;
+    s.name = name;
+    s.depth = depth;
+    scopes.push_back(s);
+    return scopes.back();
+}
+
+/**
+ * @brief Converte os timestamps de um frame em amostras por scope
+ */
+void GpuProfiler::collect(Frame& frame) {
+    const size_t count = frame.records.size();
+    paths.resize(count);
+    frameTotals.assign(scopes.size(), 0.0);
+
+    touched.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const Record& record = frame.records[i];
+        paths[i] = record.parent >= 0 ? paths[record.parent] + "/" + record.name : std::string(record.name);
+
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        const double ms = end > start ? (end - start) / 1.0e6 : 0.0;
+
+        GpuScopeStats& stats = statsFor(paths[i], record.name, record.depth);
+        const int slot = static_cast<int>(&stats - scopes.data());
+        if (slot >= static_cast<int>(frameTotals.size())) frameTotals.resize(slot + 1, 0.0);
+        if (std::find(touched.begin(), touched.end(), slot) == touched.end()) touched.push_back(slot);
+        frameTotals[slot] += ms;
+    }
+
+    // Uma amostra por scope e por frame (intervalos repetidos já somados)
+    for (int slot : touched) {
+        GpuScopeStats& stats = scopes[slot];
+        const double ms = frameTotals[slot];
+        stats.history[stats.samples % GpuScopeStats::WINDOW] = ms;
+        ++stats.samples;
+        stats.lastMs = ms;
+
+        const int window = static_cast<int>(std::min<unsigned int>(stats.samples, GpuScopeStats::WINDOW));
+        double sum = 0.0;
+        stats.minMs = stats.maxMs = stats.history[0];
+        for (int i = 0; i < window; ++i) {
+            sum += stats.history[i];
+            stats.minMs = std::min(stats.minMs, stats.history[i]);
+            stats.maxMs = std::max(stats.maxMs, stats.history[i]);
+        }
+        stats.averageMs = sum / window;
+    }
+
+    ++measuredFrames;
+    frame.pending = false;
+}
+
+const GpuScopeStats* GpuProfiler::find(const std::string& path) const {
+    for (const GpuScopeStats& s : scopes) {
+        if (s.path == path) return &s;
+    }
+    return nullptr;
+}
+
+void GpuProfiler::report(std::ostream& out) const {
+    out << "GPU: " << measuredFrames << " frames medidos, " << skippedFrames << " ignorados" << std::endl;
+    out << std::left << std::setw(36) << "scope" << std::right
+        << std::setw(10) << "ultimo" << std::setw(10) << "media"
+        << std::setw(10) << "min" << std::setw(10) << "max" << "  (ms)" << std::endl;
+
+    out << std::fixed << std::setprecision(3);
+    for (const GpuScopeStats& s : scopes) {
+        out << std::left << std::setw(36) << (std::string(s.depth * 2, ' ') + s.name) << std::right
+            << std::setw(10) << s.lastMs << std::setw(10) << s.averageMs
+            << std::setw(10) << s.minMs << std::setw(10) << s.maxMs << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+bool GpuProfiler::dump(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+    report(file);
+    return true;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string, vector: nomes e estatísticas dos scopes
+ * - ostream: relatório em texto
+ * - GL/glew: queries de tempo (GL_TIMESTAMP)
+ */
+#include <string>
+#include <vector>
+#include <ostream>
+#include <GL/glew.h>
+
+/**
+ * @brief Estatísticas acumuladas de um scope medido na GPU
+ */
+struct GpuScopeStats {
+    std::string path;           // Caminho completo ("frame/render_queue/principal/opaque/bolas")
+    std::string name;           // Último elemento do caminho
+    int depth = 0;              // Nível de aninhamento (0 = raiz)
+    double lastMs = 0.0;        // Último frame medido
+    double averageMs = 0.0;     // Média dos últimos WINDOW frames medidos
+    double minMs = 0.0;         // Mínimo e máximo dentro da mesma janela
+    double maxMs = 0.0;
+    unsigned int samples = 0;   // Frames medidos desde o início
+
+    static const int WINDOW = 60;
+    double history[WINDOW] = {}; // Amostras recentes (anel)
+};
+
+/**
+ * @brief Profiler de GPU por scopes com nome
+ *
+ * Cada scope coloca uma query GL_TIMESTAMP (glQueryCounter) no início e
+ * outra no fim. Ao contrário de GL_TIME_ELAPSED, os timestamps podem ser
+ * aninhados e não colidem com a query de tempo do frame usada pela
+ * resolução dinâmica.
+ *
+ * As queries de cada frame ficam num anel de RING_SIZE frames e só são
+ * lidas quando o anel volta à mesma entrada; se a GPU ainda não tiver
+ * terminado esse frame, o frame atual não é medido (em vez de esperar).
+ * Um scope que aparece várias vezes no mesmo frame (p.ex. a mesa entre
+ * bolas ordenadas por profundidade) soma os seus intervalos.
+ *
+ * Os nomes dos scopes devem ser literais (ou strings que vivam pelo
+ * menos RING_SIZE frames).
+ */
+class GpuProfiler {
+public:
+    ~GpuProfiler() { destroy(); }
+
+    /**
+     * @brief Cria as queries de todos os frames do anel
+     */
+    void init();
+
+    /**
+     * @brief Liberta as queries
+     */
+    void destroy();
+
+    /**
+     * @brief Recolhe o frame mais antigo do anel (se a GPU já o terminou) e começa um novo
+     */
+    void beginFrame();
+
+    /**
+     * @brief Termina o frame atual (fecha scopes que tenham ficado abertos)
+     */
+    void endFrame();
+
+    /**
+     * @brief Abre um scope aninhado no scope atual
+     */
+    void beginScope(const char* name);
+
+    /**
+     * @brief Fecha o scope aberto mais recente
+     */
+    void endScope();
+
+    /**
+     * @brief Ativa ou suspende a medição (as estatísticas são mantidas)
+     */
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+    bool isMeasuring() const { return measuring; }
+
+    /**
+     * @brief Estatísticas de todos os scopes, pela ordem em que apareceram
+     */
+    const std::vector<GpuScopeStats>& getScopes() const { return scopes; }
+
+    /**
+     * @brief Procura um scope pelo caminho completo
+     * @return nullptr se o scope nunca foi medido
+     */
+    const GpuScopeStats* find(const std::string& path) const;
+
+    unsigned int getMeasuredFrames() const { return measuredFrames; }
+    unsigned int getSkippedFrames() const { return skippedFrames; }
+
+    /**
+     * @brief Escreve a tabela de tempos (último, média, mínimo, máximo)
+     */
+    void report(std::ostream& out) const;
+
+    /**
+     * @brief Grava o relatório num ficheiro de texto
+     * @return false se o ficheiro não pôde ser criado
+     */
+    bool dump(const std::string& path) const;
+
+private:
+    static const int RING_SIZE = 4;          // Frames em voo antes da leitura
+    static const int MAX_SCOPES = 64;        // Scopes por frame (2 queries cada)
+
+    // Scope registado num frame do anel
+    struct Record {
+        const char* name;
+        int parent;                          // Índice do scope pai no mesmo frame (-1 = raiz)
+        int depth;
+    };
+
+    // Entrada do anel: queries e scopes de um frame
+    struct Frame {
+        GLuint queries[MAX_SCOPES * 2] = {}; // [2i] início, [2i + 1] fim
+        std::vector<Record> records;
+        bool pending = false;                // Frame emitido à espera de leitura
+        int lastQuery = 0;                   // Última query emitida no frame
+    };
+
+    void collect(Frame& frame);
+    GpuScopeStats& statsFor(const std::string& path, const char* name, int depth);
+
+    Frame frames[RING_SIZE];
+    int current = 0;
+    bool enabled = true;
+    bool measuring = false;                  // O frame atual está a ser medido
+    std::vector<int> stack;                  // Scopes abertos no frame atual (-1 = descartado)
+
+    std::vector<GpuScopeStats> scopes;
+    std::vector<std::string> paths;          // Auxiliar de collect(): caminho de cada registo
+    std::vector<double> frameTotals;         // Auxiliar de collect(): soma por scope no frame
+    std::vector<int> touched;                // Auxiliar de collect(): scopes presentes no frame
+    unsigned int measuredFrames = 0;
+    unsigned int skippedFrames = 0;          // Frames não medidos (GPU atrasada)
+};
+
+/**
+ * @brief Scope de GPU delimitado pelo tempo de vida do objeto
+ */
+class GpuScope {
+public:
+    GpuScope(GpuProfiler& profiler, const char* name) : profiler(profiler) { profiler.beginScope(name); }
+    ~GpuScope() { profiler.endScope(); }
+
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+
+private:
+    GpuProfiler& profiler;
+};
@@ -0,0 +1,206 @@
+/***********************************************************************
+ * Implementação do Contexto sem Janela
+ *
+ * Cria um contexto OpenGL core profile sem ecrã (EGL ou OSMesa) ou, na
+ * falta destes, uma janela GLFW invisível.
+ ***********************************************************************/
+
+#include "headless.h"
+#include <fstream>
+#include <iostream>
+
+#if defined(P3D_HEADLESS_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#elif defined(P3D_HEADLESS_OSMESA)
+#include <GL/osmesa.h>
+#else
+#include <GLFW/glfw3.h>
+#endif
+
+// Versões tentadas por ordem decrescente (o mínimo exigido pelos shaders é 3.3)
+static const int contextVersions[][2] = { {4, 6}, {4, 5}, {4, 4}, {4, 3}, {3, 3} };
+
+#if defined(P3D_HEADLESS_EGL)
+
+bool HeadlessContext::create(int width, int height) {
+    destroy();
+
+    // Prefere a plataforma sem superfície do Mesa; senão usa o ecrã por omissão
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "EGL: falha ao inicializar o display" << std::endl;
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+
+    // EGL_SURFACE_TYPE por omissão é EGL_WINDOW_BIT, que a plataforma sem superfície não oferece
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+        std::cerr << "EGL: nenhuma configuracao OpenGL disponivel" << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    EGLContext eglContext = EGL_NO_CONTEXT;
+    for (const auto& version : contextVersions) {
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, version[0],
+            EGL_CONTEXT_MINOR_VERSION, version[1],
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+        if (eglContext != EGL_NO_CONTEXT) break;
+    }
+
+    // Sem superfícies: todo o desenho é feito em framebuffers próprios
+    if (eglContext == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+        std::cerr << "EGL: falha ao criar o contexto" << std::endl;
+        if (eglContext != EGL_NO_CONTEXT) eglDestroyContext(eglDisplay, eglContext);
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    display = eglDisplay;
+    context = eglContext;
+    created = true;
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (!created) return;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+    display = context = nullptr;
+    created = false;
+}
+
+const char* HeadlessContext::getBackend() const { return "egl"; }
+
+#elif defined(P3D_HEADLESS_OSMESA)
+
+bool HeadlessContext::create(int width, int height) {
+    destroy();
+
+    OSMesaContext osContext = nullptr;
+    for (const auto& version : contextVersions) {
+        const int attribs[] = {
+            OSMESA_FORMAT, OSMESA_RGBA,
+            OSMESA_DEPTH_BITS, 24,
+            OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+            OSMESA_CONTEXT_MAJOR_VERSION, version[0],
+            OSMESA_CONTEXT_MINOR_VERSION, version[1],
+            0
+        };
+        osContext = OSMesaCreateContextAttribs(attribs, nullptr);
+        if (osContext) break;
+    }
+
+    colorBuffer.resize(static_cast<size_t>(width) * height * 4);
+    if (!osContext || !OSMesaMakeCurrent(osContext, colorBuffer.data(), GL_UNSIGNED_BYTE, width, height)) {
+        std::cerr << "OSMesa: falha ao criar o contexto" << std::endl;
+        if (osContext) OSMesaDestroyContext(osContext);
+        return false;
+    }
+
+    context = osContext;
+    created = true;
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (!created) return;
+    OSMesaDestroyContext(static_cast<OSMesaContext>(context));
+    context = nullptr;
+    colorBuffer.clear();
+    created = false;
+}
+
+const char* HeadlessContext::getBackend() const { return "osmesa"; }
+
+#else
+
+bool HeadlessContext::create(int width, int height) {
+    destroy();
+
+    if (!glfwInit()) {
+        std::cerr << "Falha ao inicializar GLFW" << std::endl;
+        return false;
+    }
+
+    glfwSetErrorCallback(nullptr);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    for (const auto& version : contextVersions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(width, height, "Bilhar (headless)", nullptr, nullptr);
+        if (window) break;
+    }
+
+    if (!window) {
+        std::cerr << "Falha ao criar janela invisivel" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    created = true;
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (!created) return;
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    window = nullptr;
+    created = false;
+}
+
+const char* HeadlessContext::getBackend() const { return "glfw-hidden"; }
+
+#endif
+
+bool saveFramebufferPPM(GLuint framebuffer, GLsizei width, GLsizei height, const std::string& path) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Nao foi possivel criar " << path << std::endl;
+        return false;
+    }
+
+    // O OpenGL devolve as linhas de baixo para cima; o PPM começa no topo
+    file << "P6\n" << width << " " << height << "\n255\n";
+    const size_t rowSize = static_cast<size_t>(width) * 3;
+    for (GLsizei row = height - 1; row >= 0; --row) {
+        file.write(reinterpret_cast<const char*>(&pixels[row * rowSize]), rowSize);
+    }
+    return static_cast<bool>(file);
+}
\ No newline at end of file
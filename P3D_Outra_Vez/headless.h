@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string: nome do backend e caminho da imagem
+ * - vector: memória de cor usada pelo OSMesa
+ * - GL/glew: leitura do framebuffer final
+ */
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+struct GLFWwindow;
+
+/**
+ * @brief Contexto OpenGL sem janela, para benchmarks e integração contínua
+ *
+ * O backend é escolhido na compilação (no Linux, opção P3D_HEADLESS do CMakeLists.txt):
+ * - P3D_HEADLESS_EGL: EGL sem superfície (EGL_MESA_platform_surfaceless),
+ *   que funciona sem servidor gráfico e com o llvmpipe. Serve o GLEW com
+ *   suporte EGL (GLEW_EGL) ou o das distribuições (GLX, ver initGL).
+ * - P3D_HEADLESS_OSMESA: OSMesa, renderização inteiramente em software.
+ * - nenhum: janela GLFW invisível (ainda precisa de um ecrã, mas permite
+ *   usar o modo em máquinas de desenvolvimento, p.ex. no Windows).
+ *
+ * Em qualquer dos casos a cena é desenhada num framebuffer próprio, por
+ * isso o framebuffer por omissão nunca é usado.
+ */
+class HeadlessContext {
+public:
+    ~HeadlessContext() { destroy(); }
+
+    /**
+     * @brief Cria o contexto core profile mais recente disponível e torna-o atual
+     * @param width, height Dimensões da imagem (usadas pelo OSMesa)
+     * @return true se o contexto ficou ativo
+     */
+    bool create(int width, int height);
+
+    /**
+     * @brief Liberta o contexto
+     */
+    void destroy();
+
+    /**
+     * @brief Nome do backend usado (para os relatórios)
+     */
+    const char* getBackend() const;
+
+private:
+    bool created = false;
+
+#if defined(P3D_HEADLESS_EGL)
+    void* display = nullptr;               // EGLDisplay
+    void* context = nullptr;               // EGLContext
+#elif defined(P3D_HEADLESS_OSMESA)
+    void* context = nullptr;               // OSMesaContext
+    std::vector<unsigned char> colorBuffer;// Destino exigido por OSMesaMakeCurrent
+#else
+    GLFWwindow* window = nullptr;
+#endif
+};
+
+/**
+ * @brief Grava a cor de um framebuffer num ficheiro PPM (binário, P6)
+ * @param framebuffer Framebuffer a ler
+ * @param width, height Região a gravar (a partir do canto inferior esquerdo)
+ * @param path Caminho do ficheiro
+ * @return true se o ficheiro foi escrito
+ */
+bool saveFramebufferPPM(GLuint framebuffer, GLsizei width, GLsizei height, const std::string& path);
\ No newline at end of file
@@ -0,0 +1,41 @@
+/***********************************************************************
+ * Implementação dos Impostores de Esferas
+ ***********************************************************************/
+
+#include "impostor.h"
+#include "model.h"
+
+bool SphereImpostor::init(GLuint colorProgram, GLuint depthOnlyProgram) {
+    destroy();
+    if (!colorProgram || !depthOnlyProgram) return false;
+
+    program = colorProgram;
+    depthProgram = depthOnlyProgram;
+    glGenVertexArrays(1, &vao);
+    return vao != 0;
+}
+
+void SphereImpostor::destroy() {
+    if (vao) {
+        glDeleteVertexArrays(1, &vao);
+        vao = 0;
+    }
+}
+
+void SphereImpostor::record(const RenderQueue& queue, RenderList& out, uint8_t viewId, const ObjModel& model) const {
+    RenderPacket packet;
+    packet.program = program;
+    packet.depthProgram = depthProgram;
+    packet.vao = vao;
+    packet.texture = model.getDiffuseTexture();
+    packet.material = model.getMaterial();
+    packet.mode = GL_TRIANGLE_STRIP;
+    packet.count = 4;
+    packet.label = "bolas";
+
+    // O shader interseta a esfera unitária: o raio da malha passa para a matriz de modelo
+    packet.model = glm::scale(model.getModelMatrix(), glm::vec3(model.getLocalRadius()));
+
+    const glm::vec4 viewPos = queue.getView(viewId).view * glm::vec4(model.getPosition(), 1.0f);
+    queue.record(out, packet, viewId, PASS_OPAQUE, -viewPos.z);
+}
\ No newline at end of file
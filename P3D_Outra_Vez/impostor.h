@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - GL/glew: VAO vazio usado pelos quads
+ * - renderqueue: pacotes de desenho
+ */
+#include <GL/glew.h>
+#include "renderqueue.h"
+
+class ObjModel;
+
+/**
+ * @brief Desenho de modelos esféricos como impostores calculados por raio
+ *
+ * Em vez da malha, cada esfera é desenhada como um quad de 2 triângulos
+ * virado para a câmera, gerado no vertex shader a partir de gl_VertexID
+ * (variante IMPOSTOR de shader.vert/shader.frag). O fragment shader
+ * interseta o raio de cada pixel com a esfera e escreve a profundidade,
+ * a normal e as coordenadas de textura exatas do ponto de impacto: a
+ * silhueta não depende da tesselação e o custo por bola deixa de
+ * depender do número de triângulos da malha.
+ *
+ * O raio e a rotação vêm da matriz de modelo (o shader trabalha sobre a
+ * esfera unitária do espaço do objeto), por isso a textura acompanha a
+ * orientação da bola. O pre-pass de profundidade usa a variante
+ * DEPTH_ONLY do impostor, indicada em cada pacote.
+ */
+class SphereImpostor {
+public:
+    ~SphereImpostor() { destroy(); }
+
+    /**
+     * @brief Guarda os programas e cria o VAO (sem atributos) dos quads
+     * @param colorProgram Variante TEXTURED | IMPOSTOR
+     * @param depthOnlyProgram Variante DEPTH_ONLY | IMPOSTOR, usada no pre-pass
+     * @return false se algum dos programas não existir
+     */
+    bool init(GLuint colorProgram, GLuint depthOnlyProgram);
+
+    /**
+     * @brief Apaga o VAO
+     */
+    void destroy();
+
+    /**
+     * @brief Constrói o pacote do impostor de um modelo numa lista externa (seguro entre threads)
+     *
+     * O programa e a textura devem ter sido registados antes com
+     * RenderQueue::registerState.
+     *
+     * @param queue Fila que define as vistas e as chaves
+     * @param out Lista que recebe o pacote
+     * @param viewId Índice da vista
+     * @param model Modelo esférico centrado na origem do seu espaço de objeto, com textura difusa
+     */
+    void record(const RenderQueue& queue, RenderList& out, uint8_t viewId, const ObjModel& model) const;
+
+    bool isReady() const { return vao != 0; }
+    GLuint getProgram() const { return program; }
+    GLuint getDepthProgram() const { return depthProgram; }
+
+private:
+    GLuint vao = 0;           // VAO vazio: o core profile exige um VAO ligado para desenhar
+    GLuint program = 0;
+    GLuint depthProgram = 0;
+};
\ No newline at end of file
@@ -0,0 +1,226 @@
+/***********************************************************************
+ * Implementação do Leitor de JSON
+ ***********************************************************************/
+
+#include "jsonvalue.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Analisador descendente recursivo sobre o texto completo
+ */
+class JsonParser {
+public:
+    JsonParser(const std::string& source) : begin(source.c_str()), cursor(begin), end(begin + source.size()) {}
+
+    bool parseDocument(JsonValue& out) {
+        if (!parseValue(out, 0)) return false;
+        skipSpace();
+        return cursor == end || fail("conteudo depois do valor");
+    }
+
+    std::string error;
+
+private:
+    // Limite de aninhamento, para um ficheiro malformado não esgotar a pilha
+    static constexpr int MAX_DEPTH = 64;
+
+    bool fail(const char* message) {
+        std::ostringstream text;
+        text << message << " (posicao " << (cursor - begin) << ")";
+        error = text.str();
+        return false;
+    }
+
+    void skipSpace() {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r')) ++cursor;
+    }
+
+    bool match(const char* word) {
+        const size_t length = std::strlen(word);
+        if (static_cast<size_t>(end - cursor) < length || std::strncmp(cursor, word, length) != 0) return false;
+        cursor += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > MAX_DEPTH) return fail("aninhamento demasiado profundo");
+        skipSpace();
+        if (cursor == end) return fail("fim inesperado");
+
+        switch (*cursor) {
+        case '{': return parseObject(out, depth);
+        case '[': return parseArray(out, depth);
+        case '"':
+            out.type = JsonValue::JSON_STRING;
+            return parseString(out.text);
+        case 't':
+        case 'f':
+            out.type = JsonValue::JSON_BOOL;
+            out.boolean = *cursor == 't';
+            return match(out.boolean ? "true" : "false") || fail("literal invalido");
+        case 'n':
+            out.type = JsonValue::JSON_NULL;
+            return match("null") || fail("literal invalido");
+        default:
+            return parseNumber(out);
+        }
+    }
+
+    bool parseNumber(JsonValue& out) {
+        // strtod aceita mais do que o JSON (hex, inf), mas basta para ficheiros gerados por nós
+        char* stop = nullptr;
+        const double value = std::strtod(cursor, &stop);
+        if (stop == cursor || stop > end) return fail("numero invalido");
+        cursor = stop;
+        out.type = JsonValue::JSON_NUMBER;
+        out.number = value;
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++cursor; // '"'
+        out.clear();
+        while (cursor < end && *cursor != '"') {
+            char c = *cursor++;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (cursor == end) break;
+            switch (*cursor++) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (end - cursor < 4) return fail("escape unicode incompleto");
+                const unsigned long code = std::strtoul(std::string(cursor, 4).c_str(), nullptr, 16);
+                cursor += 4;
+                // Codificado em UTF-8 (os pares substitutos não são combinados)
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                }
+                else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return fail("escape invalido");
+            }
+        }
+        if (cursor == end) return fail("string sem fim");
+        ++cursor; // '"'
+        return true;
+    }
+
+    bool parseArray(JsonValue& out, int depth) {
+        ++cursor; // '['
+        out.type = JsonValue::JSON_ARRAY;
+        skipSpace();
+        if (cursor < end && *cursor == ']') {
+            ++cursor;
+            return true;
+        }
+        for (;;) {
+            out.items.emplace_back();
+            if (!parseValue(out.items.back(), depth + 1)) return false;
+            skipSpace();
+            if (cursor < end && *cursor == ',') { ++cursor; continue; }
+            if (cursor < end && *cursor == ']') { ++cursor; return true; }
+            return fail("esperado ',' ou ']'");
+        }
+    }
+
+    bool parseObject(JsonValue& out, int depth) {
+        ++cursor; // '{'
+        out.type = JsonValue::JSON_OBJECT;
+        skipSpace();
+        if (cursor < end && *cursor == '}') {
+            ++cursor;
+            return true;
+        }
+        for (;;) {
+            skipSpace();
+            if (cursor == end || *cursor != '"') return fail("esperada chave");
+            out.keys.emplace_back();
+            if (!parseString(out.keys.back())) return false;
+            skipSpace();
+            if (cursor == end || *cursor != ':') return fail("esperado ':'");
+            ++cursor;
+            out.items.emplace_back();
+            if (!parseValue(out.items.back(), depth + 1)) return false;
+            skipSpace();
+            if (cursor < end && *cursor == ',') { ++cursor; continue; }
+            if (cursor < end && *cursor == '}') { ++cursor; return true; }
+            return fail("esperado ',' ou '}'");
+        }
+    }
+
+    const char* begin;
+    const char* cursor;
+    const char* end;
+};
+
+bool JsonValue::parse(const std::string& text, JsonValue& out, std::string* error) {
+    out = JsonValue();
+    JsonParser parser(text);
+    if (parser.parseDocument(out)) return true;
+    if (error) *error = parser.error;
+    return false;
+}
+
+bool JsonValue::load(const std::string& path, JsonValue& out, std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) *error = "nao foi possivel abrir " + path;
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return parse(contents.str(), out, error);
+}
+
+void JsonValue::writeString(std::ostream& out, const std::string& text) {
+    static const char* const hex = "0123456789abcdef";
+    out << '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c < 0x20) out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+        else out << c;
+    }
+    out << '"';
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    if (type != JSON_OBJECT) return nullptr;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == key) return &items[i];
+    }
+    return nullptr;
+}
+
+const JsonValue* JsonValue::findPath(const std::string& path) const {
+    const JsonValue* value = this;
+    size_t start = 0;
+    while (value) {
+        const size_t dot = path.find('.', start);
+        value = value->find(path.substr(start, dot == std::string::npos ? std::string::npos : dot - start));
+        if (dot == std::string::npos) break;
+        start = dot + 1;
+    }
+    return value;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - ostream: escrita de strings escapadas
+ * - string: chaves, strings e caminho do ficheiro
+ * - vector: elementos de arrays e membros de objetos
+ */
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Valor JSON lido de um ficheiro (objeto, array, string, número, booleano ou null)
+ *
+ * Leitor mínimo para os relatórios de --bench e a baseline de desempenho.
+ * Os membros de um objeto mantêm a ordem do ficheiro; a procura por chave
+ * é linear, suficiente para os poucos campos destes ficheiros.
+ */
+class JsonValue {
+public:
+    enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+
+    /**
+     * @brief Interpreta um texto JSON
+     * @param error Recebe a descrição e a posição do primeiro erro (opcional)
+     * @return false se o texto não for JSON válido
+     */
+    static bool parse(const std::string& text, JsonValue& out, std::string* error = nullptr);
+
+    /**
+     * @brief Lê e interpreta um ficheiro JSON
+     * @return false se o ficheiro não existir ou não for JSON válido
+     */
+    static bool load(const std::string& path, JsonValue& out, std::string* error = nullptr);
+
+    /**
+     * @brief Escreve uma string JSON, com as aspas, barras e caracteres de controlo escapados
+     */
+    static void writeString(std::ostream& out, const std::string& text);
+
+    Type getType() const { return type; }
+    bool isNull() const { return type == JSON_NULL; }
+    bool isNumber() const { return type == JSON_NUMBER; }
+    bool isObject() const { return type == JSON_OBJECT; }
+
+    double asNumber(double fallback = 0.0) const { return type == JSON_NUMBER ? number : fallback; }
+    bool asBool(bool fallback = false) const { return type == JSON_BOOL ? boolean : fallback; }
+    const std::string& asString() const { return text; }
+
+    /**
+     * @brief Membro de um objeto
+     * @return nullptr se não for um objeto ou a chave não existir
+     */
+    const JsonValue* find(const std::string& key) const;
+
+    /**
+     * @brief Membro aninhado indicado por chaves separadas por pontos ("frame_ms.p50")
+     */
+    const JsonValue* findPath(const std::string& path) const;
+
+    /**
+     * @brief Número de elementos (array) ou de membros (objeto)
+     */
+    size_t size() const { return items.size(); }
+    const JsonValue& at(size_t index) const { return items[index]; }
+    const std::string& keyAt(size_t index) const { return keys[index]; }
+
+private:
+    friend class JsonParser;
+
+    Type type = JSON_NULL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    std::vector<std::string> keys;    // Chaves dos membros (só objetos)
+    std::vector<JsonValue> items;     // Elementos do array ou valores dos membros
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#version 330 core
+
+// Iluminação clustered forward (ver ClusteredLighting)
+// Ligado como segundo fragment shader às variantes com cor de shader.frag e aos programas de multi-draw,
+// que declaram shadeClustered() e lhe passam a posição e a normal no espaço da vista.
+
+uniform vec3 ambientLight;
+
+// Grelha da vista atual (um bloco por vista, ligado pela RenderQueue quando a vista muda)
+layout(std140) uniform ClusterGrid {
+    vec4 tileOrigin;    // xy: canto do viewport em pixels; zw: tiles por pixel
+    vec4 depthSlicing;  // x: escala, y: deslocamento, z: 1 = fatias logarítmicas (perspetiva), 0 = lineares
+    uvec4 gridSize;     // xyz: clusters em cada eixo; w: primeiro cluster da vista (x = 0: vista sem luzes)
+};
+
+uniform samplerBuffer lightData;      // 2 texels por luz: (posição na vista, raio), (cor * intensidade, 0)
+uniform usamplerBuffer clusterRanges; // Por cluster: primeiro índice em lightIndices, número de luzes
+uniform usamplerBuffer lightIndices;  // Listas de luzes de todos os clusters, seguidas
+
+/**
+ * Phong com a luz ambiente e as luzes pontuais do cluster do fragmento
+ * position e normal no espaço da vista (normal normalizada); ka, kd, ks e ns do material.
+ */
+vec3 shadeClustered(vec3 baseColor, vec3 position, vec3 normal, vec3 ka, vec3 kd, vec3 ks, float ns) {
+    vec3 color = ka * ambientLight * baseColor;
+    if (gridSize.x == 0u) return color;
+
+    // Cluster: tile do ecrã e fatia da profundidade
+    bool perspective = depthSlicing.z > 0.5;
+    float depth = max(-position.z, 1e-4);
+    float slice = (perspective ? log(depth) : depth) * depthSlicing.x + depthSlicing.y;
+    ivec3 cell = ivec3(ivec2((gl_FragCoord.xy - tileOrigin.xy) * tileOrigin.zw), int(slice));
+    cell = clamp(cell, ivec3(0), ivec3(gridSize.xyz) - 1);
+    int cluster = int(gridSize.w) + (cell.z * int(gridSize.y) + cell.y) * int(gridSize.x) + cell.x;
+    uvec2 range = texelFetch(clusterRanges, cluster).xy;
+
+    vec3 viewDirection = perspective ? normalize(-position) : vec3(0.0, 0.0, 1.0);
+    for (uint i = 0u; i < range.y; ++i) {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).x);
+        vec4 positionRadius = texelFetch(lightData, 2 * light);
+        vec3 lightColor = texelFetch(lightData, 2 * light + 1).rgb;
+
+        vec3 toLight = positionRadius.xyz - position;
+        float distance = length(toLight);
+        vec3 lightDirection = toLight / max(distance, 1e-4);
+
+        // Atenuação que chega a 0 no alcance da luz (o mesmo raio usado na atribuição aos clusters)
+        float falloff = clamp(1.0 - distance / positionRadius.w, 0.0, 1.0);
+        falloff *= falloff;
+
+        float diffuse = max(dot(normal, lightDirection), 0.0);
+        float specular = diffuse > 0.0 ? pow(max(dot(reflect(-lightDirection, normal), viewDirection), 0.0), ns) : 0.0;
+        color += falloff * lightColor * (kd * diffuse * baseColor + ks * specular);
+    }
+    return color;
+}
\ No newline at end of file
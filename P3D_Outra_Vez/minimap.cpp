@@ -0,0 +1,34 @@
+/***********************************************************************
+ * Implementação do Minimapa em Cache
+ ***********************************************************************/
+
+#include "minimap.h"
+
+bool MinimapCache::init(GLsizei size, double maxRefreshHz) {
+    minInterval = (maxRefreshHz > 0.0) ? 1.0 / maxRefreshHz : 0.0;
+    valid = false;
+    return target.create(size, size);
+}
+
+bool MinimapCache::shouldRefresh(double now, unsigned long long sceneVersion) {
+    // Sem textura válida tem de ser renderizado imediatamente
+    bool refresh = !valid;
+
+    // Cena alterada: atualiza, respeitando a frequência máxima
+    if (!refresh && sceneVersion != cachedVersion) {
+        refresh = (now - lastRefresh) >= minInterval;
+    }
+
+    if (refresh) {
+        valid = true;
+        cachedVersion = sceneVersion;
+        lastRefresh = now;
+        ++refreshCount;
+    }
+    return refresh;
+}
+
+void MinimapCache::present(GLint x, GLint y, GLuint dstFramebuffer) const {
+    // Tamanho 1:1, não é preciso filtrar
+    target.blitTo(dstFramebuffer, x, y, target.getWidth(), target.getHeight(), GL_NEAREST);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - rendertarget: textura onde o minimapa fica guardado entre frames
+ */
+#include "rendertarget.h"
+
+/**
+ * @brief Minimapa guardado numa textura e atualizado só quando a cena muda
+ *
+ * A câmera do minimapa é fixa, por isso a imagem só precisa de ser
+ * refeita quando algum objeto se move (ou a iluminação muda). Mesmo
+ * assim, a atualização é limitada a uma frequência máxima para que um
+ * objeto em movimento contínuo não volte a custar uma vista por frame.
+ * Nos restantes frames a textura é apenas copiada para a janela.
+ */
+class MinimapCache {
+public:
+    /**
+     * @brief Cria a textura do minimapa
+     * @param size Largura e altura em pixels
+     * @param maxRefreshHz Frequência máxima de atualização
+     */
+    bool init(GLsizei size, double maxRefreshHz);
+
+    /**
+     * @brief Liberta a textura (com o contexto ainda ativo)
+     */
+    void destroy() { target.destroy(); valid = false; }
+
+    /**
+     * @brief Decide se o minimapa deve ser renderizado neste frame
+     *
+     * Quando devolve true, considera a textura atualizada para a versão
+     * indicada; o chamador deve então renderizar a vista para o alvo.
+     *
+     * @param now Tempo atual em segundos
+     * @param sceneVersion Valor que muda sempre que a cena visível muda
+     */
+    bool shouldRefresh(double now, unsigned long long sceneVersion);
+
+    /**
+     * @brief Força a atualização no próximo frame
+     */
+    void invalidate() { valid = false; }
+
+    /**
+     * @brief Copia o minimapa para a imagem final
+     * @param x, y Canto inferior esquerdo no destino
+     * @param dstFramebuffer Framebuffer de destino (0 = janela)
+     */
+    void present(GLint x, GLint y, GLuint dstFramebuffer = 0) const;
+
+    const RenderTarget& getTarget() const { return target; }
+    unsigned int getRefreshCount() const { return refreshCount; }
+
+private:
+    RenderTarget target;
+    double minInterval = 0.1;              // Intervalo mínimo entre atualizações (s)
+    double lastRefresh = 0.0;              // Instante da última atualização
+    unsigned long long cachedVersion = 0;  // Versão da cena guardada na textura
+    bool valid = false;                    // A textura contém uma imagem utilizável
+    unsigned int refreshCount = 0;         // Número de atualizações feitas
+};
@@ -1,50 +1,75 @@
 /***********************************************************************
- * Implementao do Sistema de Carregamento e Renderizao de Modelos 3D
+ * Implementação do Sistema de Carregamento e Renderização de Modelos 3D
  *
  * Este arquivo implementa um sistema completo para carregar modelos 3D
  * no formato OBJ, incluindo:
- * - Carregamento de geometria (vrtices, normais, coordenadas UV)
+ * - Carregamento de geometria (vértices, normais, coordenadas UV)
  * - Suporte a materiais e texturas
- * - Sistema de renderizao otimizado com OpenGL moderno
+ * - Sistema de renderização otimizado com OpenGL moderno
  ***********************************************************************/
 
 #include "model.h"
-#define STB_IMAGE_IMPLEMENTATION  // Necessrio para implementao da biblioteca stb_image
+#define STB_IMAGE_IMPLEMENTATION  // Necessário para implementação da biblioteca stb_image
 #include "stb_image.h"
+#include "cpuprofiler.h"
+#include "gpumemory.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
  /**
   * @brief Construtor da classe ObjModel
   *
   * Inicializa um modelo 3D a partir de um arquivo OBJ em duas etapas:
-  * 1. Carrega os dados geomtricos e materiais do arquivo
-  * 2. Prepara os buffers do OpenGL para renderizao eficiente
+  * 1. Carrega os dados geométricos e materiais do arquivo
+  * 2. Prepara os buffers do OpenGL para renderização eficiente
+  *
+  * A transformação é criada no TransformStore com a orientação por
+  * omissão dos modelos (90 graus em torno de Y).
   *
   * @param path Caminho completo para o arquivo .obj
+  * @param transformStore Armazenamento partilhado das transformações
   */
-ObjModel::ObjModel(const std::string& path) {
+ObjModel::ObjModel(const std::string& path, TransformStore& transformStore) :
+    transforms(transformStore),
+    transform(transformStore.create(glm::vec3(0.0f),
+        glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+        glm::vec3(1.0f))) {
     loadOBJ(path);    // Carrega os dados do arquivo
     install();        // Configura os buffers do OpenGL
 }
 
+ObjModel::ObjModel(const ObjModel& source, TransformStore& transformStore) :
+    VAO(0), VBO(0), EBO(0),
+    transforms(transformStore),
+    transform(transformStore.create(glm::vec3(0.0f),
+        glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+        glm::vec3(1.0f))),
+    prototype(&source.shared()) {
+}
+
+bool ObjModel::shareTextures = false;
+std::map<std::string, GLuint> ObjModel::textureCache;
+
 /**
  * @brief Carrega e processa um arquivo OBJ
  *
- * Realiza a leitura e interpretao do arquivo OBJ linha por linha.
+ * Realiza a leitura e interpretação do arquivo OBJ linha por linha.
  * Processa os seguintes elementos:
- * - v: Vrtices (coordenadas x, y, z no espao 3D)
+ * - v: Vértices (coordenadas x, y, z no espaço 3D)
  * - vt: Coordenadas de textura (u, v para mapeamento 2D)
- * - vn: Normais dos vrtices (direo perpendicular  superfcie)
- * - f: Faces (tringulos definidos por ndices)
+ * - vn: Normais dos vértices (direção perpendicular à superfície)
+ * - f: Faces (triângulos definidos por índices)
  * - mtllib: Arquivo de materiais associado
- * - usemtl: Seleo do material atual
+ * - usemtl: Seleção do material atual
  *
  * @param path Caminho do arquivo OBJ a ser carregado
  */
 void ObjModel::loadOBJ(const std::string& path) {
+    PROFILE_ZONE("ObjModel::loadOBJ");
+
     // Abre o arquivo OBJ
     std::ifstream file(path);
     if (!file.is_open()) {
@@ -59,11 +84,12 @@ void ObjModel::loadOBJ(const std::string& path) {
         std::string type;
         ss >> type;
 
-        // Processa vrtices (posies 3D)
+        // Processa vértices (posições 3D)
         if (type == "v") {
             glm::vec3 v;
             ss >> v.x >> v.y >> v.z;
             vertices.push_back(v);
+            boundingRadius = std::max(boundingRadius, glm::length(v));
         }
         // Processa coordenadas de textura (UV)
         else if (type == "vt") {
@@ -71,26 +97,26 @@ void ObjModel::loadOBJ(const std::string& path) {
             ss >> vt.x >> vt.y;
             texcoords.push_back(vt);
         }
-        // Processa normais dos vrtices
+        // Processa normais dos vértices
         else if (type == "vn") {
             glm::vec3 vn;
             ss >> vn.x >> vn.y >> vn.z;
             normals.push_back(vn);
         }
-        // Processa faces (tringulos)
+        // Processa faces (triângulos)
         else if (type == "f") {
             std::string v1, v2, v3;
             ss >> v1 >> v2 >> v3;
             std::string verts[] = { v1, v2, v3 };
 
-            // Processa cada vrtice da face (formato: v/vt/vn)
+            // Processa cada vértice da face (formato: v/vt/vn)
             for (std::string& vert : verts) {
-                // Converte separadores '/' em espaos para facilitar a leitura
+                // Converte separadores '/' em espaços para facilitar a leitura
                 std::replace(vert.begin(), vert.end(), '/', ' ');
                 std::istringstream vs(vert);
                 unsigned int vi, ti, ni;
                 vs >> vi >> ti >> ni;
-                // Ajusta ndices (OBJ usa base 1, C++ usa base 0)
+                // Ajusta índices (OBJ usa base 1, C++ usa base 0)
                 vertexIndices.push_back(vi - 1);
                 texcoordIndices.push_back(ti - 1);
                 normalIndices.push_back(ni - 1);
@@ -101,7 +127,7 @@ void ObjModel::loadOBJ(const std::string& path) {
             std::string mtlFile;
             ss >> mtlFile;
 
-            // Obtm o diretrio base do OBJ para localizar o arquivo MTL
+            // Obtém o diretório base do OBJ para localizar o arquivo MTL
             size_t lastSlash = path.find_last_of("/\\");
             std::string basePath = (lastSlash != std::string::npos) ?
                 path.substr(0, lastSlash + 1) : "";
@@ -114,43 +140,108 @@ void ObjModel::loadOBJ(const std::string& path) {
     }
     file.close();
 
+    // Esferas com o mapeamento das bolas: a normal e o UV são calculados no shader
+    sphereVertices = matchesSphereMapping();
+
     // Organiza os dados em formato intercalado para o OpenGL
-    // Cada vrtice ter: [posio(xyz), normal(xyz), texcoord(uv)]
+    // Cada vértice terá: [posição(xyz), normal(xyz), texcoord(uv)], ou só a posição numa esfera
+    // Combinações v/vt/vn repetidas reutilizam o mesmo vértice através do índice
+    // (numa esfera basta a posição: os vértices duplicados na costura passam a ser um só)
+    std::unordered_map<uint64_t, unsigned int> uniqueVertices;
+    uniqueVertices.reserve(vertexIndices.size());
+    indices.reserve(vertexIndices.size());
+
+    const int stride = getVertexStride();
     for (size_t i = 0; i < vertexIndices.size(); i++) {
+        const uint64_t key = sphereVertices ? vertexIndices[i] :
+            static_cast<uint64_t>(vertexIndices[i]) |
+            (static_cast<uint64_t>(texcoordIndices[i]) << 21) |
+            (static_cast<uint64_t>(normalIndices[i]) << 42);
+
+        auto found = uniqueVertices.find(key);
+        if (found != uniqueVertices.end()) {
+            indices.push_back(found->second);
+            continue;
+        }
+
         glm::vec3 v = vertices[vertexIndices[i]];
-        glm::vec2 t = texcoords[texcoordIndices[i]];
-        glm::vec3 n = normals[normalIndices[i]];
 
         // Adiciona os dados ao buffer intercalado
+        const unsigned int newIndex = static_cast<unsigned int>(interleaved.size() / stride);
         interleaved.push_back(v.x); interleaved.push_back(v.y); interleaved.push_back(v.z);
-        interleaved.push_back(n.x); interleaved.push_back(n.y); interleaved.push_back(n.z);
-        interleaved.push_back(t.x); interleaved.push_back(t.y);
+        if (!sphereVertices) {
+            glm::vec2 t = texcoords[texcoordIndices[i]];
+            glm::vec3 n = normals[normalIndices[i]];
+            interleaved.push_back(n.x); interleaved.push_back(n.y); interleaved.push_back(n.z);
+            interleaved.push_back(t.x); interleaved.push_back(t.y);
+        }
+
+        uniqueVertices.emplace(key, newIndex);
+        indices.push_back(newIndex);
     }
 }
 
+bool ObjModel::matchesSphereMapping() const {
+    constexpr float RADIUS_TOLERANCE = 1e-3f;   // Relativa ao raio
+    constexpr float NORMAL_TOLERANCE = 1e-3f;   // 1 - cos do desvio permitido
+    constexpr float UV_TOLERANCE = 2e-3f;       // Em coordenadas de textura
+    constexpr float POLE = 0.999f;              // |y| acima do qual u não é definido
+    constexpr float TWO_PI = 6.28318531f;
+    constexpr float PI = 3.14159265f;
+
+    if (vertices.empty() || boundingRadius <= 0.0f || texcoords.empty() || normals.empty()) return false;
+
+    for (const glm::vec3& v : vertices) {
+        if (std::abs(glm::length(v) - boundingRadius) > RADIUS_TOLERANCE * boundingRadius) return false;
+    }
+
+    for (size_t i = 0; i < vertexIndices.size(); ++i) {
+        if (vertexIndices[i] >= vertices.size() || texcoordIndices[i] >= texcoords.size() || normalIndices[i] >= normals.size()) {
+            return false;
+        }
+        const glm::vec3 direction = vertices[vertexIndices[i]] / boundingRadius;
+        const glm::vec3& normal = normals[normalIndices[i]];
+        const glm::vec2& uv = texcoords[texcoordIndices[i]];
+
+        if (glm::dot(direction, normal) < (1.0f - NORMAL_TOLERANCE) * glm::length(normal)) return false;
+        if (std::abs(uv.y - (0.5f + std::asin(glm::clamp(direction.y, -1.0f, 1.0f)) / PI)) > UV_TOLERANCE) return false;
+        if (std::abs(direction.y) > POLE) continue;
+
+        // Diferença de u módulo 1 (a costura tem u = 0 de um lado e u = 1 do outro)
+        const float u = SEAM_U - std::atan2(direction.z, direction.x) / TWO_PI;
+        const float du = std::abs(uv.x - u - std::round(uv.x - u));
+        if (du > UV_TOLERANCE) return false;
+    }
+    return true;
+}
+
 /**
- * @brief Configura os buffers do OpenGL para renderizao
+ * @brief Configura os buffers do OpenGL para renderização
  *
- * Esta funo  responsvel por:
+ * Esta função é responsável por:
  * 1. Criar e configurar o VAO (Vertex Array Object)
- * 2. Criar e preencher o VBO (Vertex Buffer Object)
- * 3. Definir o layout dos atributos de vrtice para o shader
+ * 2. Criar e preencher o VBO (Vertex Buffer Object) e o EBO (índices)
+ * 3. Definir o layout dos atributos de vértice para o shader
  *
  * Layout dos dados no buffer:
- * [px,py,pz, nx,ny,nz, u,v] - 8 floats por vrtice
- * - Posio (xyz): 3 floats, offset 0
+ * [px,py,pz, nx,ny,nz, u,v] - 8 floats por vértice
+ * - Posição (xyz): 3 floats, offset 0
  * - Normal (xyz): 3 floats, offset 3
  * - Textura (uv): 2 floats, offset 6
+ * Nas esferas só a posição: [px,py,pz] - 3 floats por vértice
  */
 void ObjModel::install() {
-    // Cria os objetos OpenGL necessrios
+    PROFILE_ZONE("ObjModel::install");
+
+    // Cria os objetos OpenGL necessários
     glGenVertexArrays(1, &VAO);  // Cria um Vertex Array Object
     glGenBuffers(1, &VBO);       // Cria um Vertex Buffer Object
+    glGenBuffers(1, &EBO);       // Cria um Element Buffer Object
 
-    // Ativa o VAO para configurao
+    // Ativa o VAO para configuração
     glBindVertexArray(VAO);
 
-    // Configura o buffer de vrtices
+    // Configura o buffer de vértices
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     // Carrega os dados intercalados no buffer
     glBufferData(GL_ARRAY_BUFFER,
@@ -158,47 +249,61 @@ void ObjModel::install() {
         interleaved.data(),
         GL_STATIC_DRAW);
 
-    // Define o tamanho de um vrtice completo (8 floats)
-    int stride = 8 * sizeof(float);
+    // Carrega os índices (ficam associados ao VAO)
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+        indices.size() * sizeof(unsigned int),
+        indices.data(),
+        GL_STATIC_DRAW);
+    GpuMemory::addBuffer(interleaved.size() * sizeof(float) + indices.size() * sizeof(unsigned int));
+
+    // Define o tamanho de um vértice (8 floats, ou 3 numa esfera)
+    int stride = getVertexStride() * sizeof(float);
 
-    // Configura o atributo de posio (location = 0)
-    glVertexAttribPointer(0,                    // ndice do atributo
-        3,                      // Nmero de componentes (xyz)
+    // Configura o atributo de posição (location = 0)
+    glVertexAttribPointer(0,                    // Índice do atributo
+        3,                      // Número de componentes (xyz)
         GL_FLOAT,              // Tipo dos dados
-        GL_FALSE,              // No normalizar
-        stride,                // Bytes entre vrtices
+        GL_FALSE,              // Não normalizar
+        stride,                // Bytes entre vértices
         (void*)0);             // Offset do primeiro componente
     glEnableVertexAttribArray(0);
 
+    // Numa esfera a normal e o UV vêm da posição (variante SPHERE_UV)
+    if (sphereVertices) {
+        glBindVertexArray(0);
+        return;
+    }
+
     // Configura o atributo de normal (location = 1)
-    glVertexAttribPointer(1,                    // ndice do atributo
-        3,                      // Nmero de componentes (xyz)
+    glVertexAttribPointer(1,                    // Índice do atributo
+        3,                      // Número de componentes (xyz)
         GL_FLOAT,              // Tipo dos dados
-        GL_FALSE,              // No normalizar
-        stride,                // Bytes entre vrtices
-        (void*)(3 * sizeof(float))); // Offset aps posio
+        GL_FALSE,              // Não normalizar
+        stride,                // Bytes entre vértices
+        (void*)(3 * sizeof(float))); // Offset após posição
     glEnableVertexAttribArray(1);
 
     // Configura o atributo de textura (location = 2)
-    glVertexAttribPointer(2,                    // ndice do atributo
-        2,                      // Nmero de componentes (uv)
+    glVertexAttribPointer(2,                    // Índice do atributo
+        2,                      // Número de componentes (uv)
         GL_FLOAT,              // Tipo dos dados
-        GL_FALSE,              // No normalizar
-        stride,                // Bytes entre vrtices
-        (void*)(6 * sizeof(float))); // Offset aps normal
+        GL_FALSE,              // Não normalizar
+        stride,                // Bytes entre vértices
+        (void*)(6 * sizeof(float))); // Offset após normal
     glEnableVertexAttribArray(2);
 
-    // Desvincula o VAO para evitar modificaes acidentais
+    // Desvincula o VAO para evitar modificações acidentais
     glBindVertexArray(0);
 }
 
 /**
  * @brief Carrega e processa um arquivo de material (.mtl)
  *
- * Esta funo:
- * 1. L as propriedades dos materiais (cores, brilho, etc.)
+ * Esta função:
+ * 1. Lê as propriedades dos materiais (cores, brilho, etc.)
  * 2. Carrega texturas associadas aos materiais
- * 3. Armazena as informaes para uso durante a renderizao
+ * 3. Armazena as informações para uso durante a renderização
  *
  * Propriedades do material:
  * - Ka: Cor ambiente (RGB)
@@ -210,6 +315,8 @@ void ObjModel::install() {
  * @param path Caminho do arquivo MTL
  */
 void ObjModel::loadMTL(const std::string& path) {
+    PROFILE_ZONE("ObjModel::loadMTL");
+
     std::ifstream file(path);
     if (!file.is_open()) {
         std::cerr << "Erro ao abrir ficheiro MTL: " << path << std::endl;
@@ -227,7 +334,7 @@ void ObjModel::loadMTL(const std::string& path) {
         // Inicia novo material
         if (type == "newmtl") {
             ss >> currentName;
-            // Cria novo material com nome padro
+            // Cria novo material com nome padrão
             materials[currentName] = Material{ currentName };
         }
         // Processa cor ambiente (Ka)
@@ -259,7 +366,7 @@ void ObjModel::loadMTL(const std::string& path) {
             std::string texFile;
             ss >> texFile;
 
-            // Constri caminho completo para a textura
+            // Constrói caminho completo para a textura
             size_t lastSlash = path.find_last_of("/\\");
             std::string basePath = (lastSlash != std::string::npos) ?
                 path.substr(0, lastSlash + 1) : "";
@@ -276,16 +383,27 @@ void ObjModel::loadMTL(const std::string& path) {
 /**
  * @brief Carrega uma imagem de textura para a GPU
  *
- * Esta funo:
+ * Esta função:
  * 1. Carrega a imagem do disco usando stb_image
  * 2. Cria e configura uma textura OpenGL
- * 3. Configura parmetros de filtragem e repetio
+ * 3. Configura parâmetros de filtragem e repetição
  *
  * @param filename Caminho do arquivo de imagem
- * @param texID Identificador da textura OpenGL (sada)
+ * @param texID Identificador da textura OpenGL (saída)
  */
 void ObjModel::loadTexture(const std::string& filename, GLuint& texID) {
-    // Inverte a imagem verticalmente (padro OpenGL)
+    PROFILE_ZONE("ObjModel::loadTexture");
+
+    // Textura já carregada por outro modelo
+    if (shareTextures) {
+        auto cached = textureCache.find(filename);
+        if (cached != textureCache.end()) {
+            texID = cached->second;
+            return;
+        }
+    }
+
+    // Inverte a imagem verticalmente (padrão OpenGL)
     stbi_set_flip_vertically_on_load(true);
 
     // Carrega a imagem do disco
@@ -299,9 +417,11 @@ void ObjModel::loadTexture(const std::string& filename, GLuint& texID) {
         return;
     }
 
-    // Determina o formato baseado no nmero de canais
+    // Determina o formato baseado no número de canais
     // RGB: 3 canais, RGBA: 4 canais
     GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
+    // Formato interno com tamanho explícito: glCopyImageSubData (array de texturas do multi-draw) exige-o
+    GLint internalFormat = (nrChannels == 4) ? GL_RGBA8 : GL_RGB8;
 
     // Cria e configura a textura OpenGL
     glGenTextures(1, &texID);
@@ -309,8 +429,8 @@ void ObjModel::loadTexture(const std::string& filename, GLuint& texID) {
 
     // Carrega os dados da imagem para a GPU
     glTexImage2D(GL_TEXTURE_2D,    // Tipo de textura
-        0,                  // Nvel de mipmap
-        format,            // Formato interno
+        0,                  // Nível de mipmap
+        internalFormat,    // Formato interno
         width,             // Largura
         height,            // Altura
         0,                 // Borda (sempre 0)
@@ -320,56 +440,92 @@ void ObjModel::loadTexture(const std::string& filename, GLuint& texID) {
 
     // Gera mipmaps automaticamente
     glGenerateMipmap(GL_TEXTURE_2D);
+    GpuMemory::addTexture(GpuMemory::imageBytes(width, height, 1, nrChannels, 0));
 
-    // Configura parmetros de filtragem e repetio
+    // Configura parâmetros de filtragem e repetição
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    // Libera a memria da imagem
+    // Libera a memória da imagem
     stbi_image_free(data);
+
+    if (shareTextures) {
+        textureCache[filename] = texID;
+    }
 }
 
 /**
- * @brief Renderiza o modelo 3D
+ * @brief Define a orientação a partir de ângulos de Euler
  *
- * Esta funo:
- * 1. Aplica transformaes de modelo (posio e escala)
- * 2. Calcula e envia a matriz MVP para o shader
- * 3. Configura texturas e materiais
- * 4. Executa o comando de desenho
+ * Mantém a convenção anterior (rotação em X, depois Y, depois Z aplicadas
+ * à matriz de modelo), convertida uma única vez para quaternião.
  *
+ * @param rot Ângulos em graus em torno de X, Y e Z
+ */
+void ObjModel::setRotation(const glm::vec3& rot) {
+    const glm::quat qx = glm::angleAxis(glm::radians(rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::quat qy = glm::angleAxis(glm::radians(rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::quat qz = glm::angleAxis(glm::radians(rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    transforms.setOrientation(transform, qx * qy * qz);
+}
+
+/**
+ * @brief Constrói o pacote de desenho do modelo numa lista externa
+ *
+ * O pacote leva o VAO, a textura do material atual e a matriz de modelo.
+ * A profundidade usada na chave é a distância do centro do modelo à
+ * câmera da vista.
+ *
+ * @param queue Fila de renderização (vistas e chaves)
+ * @param out Lista que recebe o pacote
+ * @param viewId Índice da vista
  * @param program ID do programa shader
- * @param view Matriz de visualizao da cmera
- * @param projection Matriz de projeo
  */
-void ObjModel::render(GLuint program, const glm::mat4& view, const glm::mat4& projection) const {
-    // Ativa o VAO do modelo
-    glBindVertexArray(VAO);
+void ObjModel::record(const RenderQueue& queue, RenderList& out, uint8_t viewId, GLuint program) const {
+    // Profundidade no espaço da câmera (o eixo -Z aponta para a frente)
+    const glm::vec4 viewPos = queue.getView(viewId).view * glm::vec4(getPosition(), 1.0f);
+    queue.record(out, makePacket(program), viewId, PASS_OPAQUE, -viewPos.z);
+}
 
-    // Calcula a matriz de modelo com transformaes
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
-    model = glm::scale(model, scale);  // Aplica escala aps translao
-    model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f)); // Rotao em X
-    model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f)); // Rotao em Y
-    model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f)); // Rotao em Z
-
-    // Calcula a matriz MVP final
-    glm::mat4 mvp = projection * view * model;
-
-    // Envia a matriz MVP para o shader
-    GLint mvpLoc = glGetUniformLocation(program, "MVP");
-    glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp));
-
-    // Configura a textura do material atual
-    auto it = materials.find(currentMaterialName);
-    if (it != materials.end() && it->second.diffuseTexID) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, it->second.diffuseTexID);
-    }
+RenderPacket ObjModel::makePacket(GLuint program) const {
+    RenderPacket packet;
+    packet.program = program;
+    packet.vao = shared().VAO;
+    packet.count = static_cast<GLsizei>(shared().indices.size());
+    packet.indexed = true;
+    packet.mesh = getMeshIndex();
+    packet.label = "bolas";
+    packet.model = getModelMatrix();
+    packet.material = getMaterial();
+    packet.texture = packet.material ? packet.material->diffuseTexID : 0;
+    return packet;
+}
+
+/**
+ * @brief Devolve a textura difusa do material atual
+ * @return ID da textura OpenGL, ou 0 se o material não tiver textura
+ */
+GLuint ObjModel::getDiffuseTexture() const {
+    const Material* material = getMaterial();
+    return material ? material->diffuseTexID : 0;
+}
 
-    // Desenha o modelo usando tringulos
-    glDrawArrays(GL_TRIANGLES, 0,
-        static_cast<GLsizei>(vertexIndices.size()));
+const Material* ObjModel::getMaterial() const {
+    const ObjModel& mesh = shared();
+    auto it = mesh.materials.find(mesh.currentMaterialName);
+    return (it != mesh.materials.end()) ? &it->second : nullptr;
+}
+
+/**
+ * @brief Calcula o raio da esfera envolvente no espaço do mundo
+ *
+ * A rotação não altera o raio; a escala é majorada pela maior componente.
+ *
+ * @return Raio em unidades do mundo
+ */
+float ObjModel::getBoundingRadius() const {
+    const glm::vec3 scale = getScale();
+    return shared().boundingRadius * std::max(scale.x, std::max(scale.y, scale.z));
 }
\ No newline at end of file
@@ -1,90 +1,176 @@
 #pragma once
 
 /**
- * Incluses necessrias:
+ * Inclusões necessárias:
  * - map: para armazenar materiais indexados por nome
- * - GL/glew: para funes OpenGL modernas
- * - vector: para arrays dinmicos de vrtices e outros dados
- * - string: para manipulao de nomes e caminhos
- * - glm: biblioteca de matemtica para computao grfica
+ * - unordered_map: para eliminar vértices repetidos ao gerar os índices
+ * - GL/glew: para funções OpenGL modernas
+ * - vector: para arrays dinâmicos de vértices e outros dados
+ * - string: para manipulação de nomes e caminhos
+ * - glm: biblioteca de matemática para computação gráfica
  */
 #include <map>
+#include <unordered_map>
 #include <GL/glew.h>
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "renderqueue.h"
+#include "transform.h"
 
  /**
   * @brief Estrutura que representa um material carregado de um arquivo .mtl
   *
-  * Os materiais em arquivos MTL contm informaes sobre as propriedades
-  * de superfcie dos objetos 3D, incluindo texturas e propriedades de reflexo.
+  * Os materiais em arquivos MTL contêm informações sobre as propriedades
+  * de superfície dos objetos 3D, incluindo texturas e propriedades de reflexão.
   */
 struct Material {
     std::string name;              // Nome identificador do material
     std::string diffuseTexPath;    // Caminho do arquivo da textura de cor
-    GLuint diffuseTexID = 0;       // Identificador da textura na memria da GPU
+    GLuint diffuseTexID = 0;       // Identificador da textura na memória da GPU
 
-    // Coeficientes do modelo de iluminao de Phong:
-    glm::vec3 ka = glm::vec3(0.2f); // Reflexo ambiente (luz indireta)
-    glm::vec3 kd = glm::vec3(0.8f); // Reflexo difusa (superfcies mate)
-    glm::vec3 ks = glm::vec3(1.0f); // Reflexo especular (brilhos)
-    float ns = 32.0f;               // Expoente especular (concentrao do brilho)
+    // Coeficientes do modelo de iluminação de Phong:
+    glm::vec3 ka = glm::vec3(0.2f); // Reflexão ambiente (luz indireta)
+    glm::vec3 kd = glm::vec3(0.8f); // Reflexão difusa (superfícies mate)
+    glm::vec3 ks = glm::vec3(1.0f); // Reflexão especular (brilhos)
+    float ns = 32.0f;               // Expoente especular (concentração do brilho)
 };
 
 /**
  * @brief Classe para gerenciamento de modelos 3D no formato OBJ
  *
- * Esta classe  responsvel por:
+ * Esta classe é responsável por:
  * 1. Carregar modelos 3D do formato OBJ
  * 2. Gerenciar materiais e texturas
  * 3. Renderizar o modelo usando OpenGL moderno
  */
 class ObjModel {
 public:
-    glm::vec3 position = glm::vec3(0.0f);   // Posio do modelo no espao 3D
-    glm::vec3 scale = glm::vec3(1.0f);      // Escala do modelo (1.0 = tamanho original)
-    glm::vec3 rotation = glm::vec3(0.0f, 90.0f, 0.0f); // Rotao do modelo (em graus, em torno de cada eixo)
+    // A transformação (posição, orientação, escala) vive no TransformStore partilhado
 
-    // Define a posio do modelo (existente)
-    void setPosition(const glm::vec3& pos) { position = pos; }
+    // Define a posição do modelo (existente)
+    void setPosition(const glm::vec3& pos) { transforms.setPosition(transform, pos); }
 
-    // Define a posio do modelo (existente)
-    void setRotation(const glm::vec3& rot) { rotation = rot; }
+    // Define a rotação do modelo a partir de ângulos em graus (aplicados em X, Y e Z)
+    void setRotation(const glm::vec3& rot);
 
-    // Nova funo para definir a escala do modelo
-    void setScale(const glm::vec3& newScale) { scale = newScale; }
+    // Define a orientação do modelo diretamente como quaternião
+    void setOrientation(const glm::quat& orientation) { transforms.setOrientation(transform, orientation); }
 
-    // Nova funo para definir uma escala uniforme (mesmo valor para X, Y e Z)
-    void setUniformScale(float uniformScale) { scale = glm::vec3(uniformScale); }
+    // Acumula uma rotação incremental (ex.: bola a rolar), sem passar por ângulos de Euler
+    void rotate(const glm::quat& delta) { transforms.rotate(transform, delta); }
+
+    // Nova função para definir a escala do modelo
+    void setScale(const glm::vec3& newScale) { transforms.setScale(transform, newScale); }
+
+    // Nova função para definir uma escala uniforme (mesmo valor para X, Y e Z)
+    void setUniformScale(float uniformScale) { transforms.setScale(transform, glm::vec3(uniformScale)); }
+
+    glm::vec3 getPosition() const { return transforms.getPosition(transform); }
+    glm::vec3 getScale() const { return transforms.getScale(transform); }
+    glm::quat getOrientation() const { return transforms.getOrientation(transform); }
+    TransformHandle getTransform() const { return transform; }
 
 
     /**
      * @brief Construtor que carrega um modelo 3D
      * @param path Caminho do arquivo .obj a ser carregado
+     * @param transformStore Armazenamento onde a transformação do modelo é criada
+     */
+    ObjModel(const std::string& path, TransformStore& transformStore);
+
+    /**
+     * @brief Cria uma instância que partilha a geometria, os buffers e os materiais de outro modelo
+     *
+     * Só a transformação é própria; o protótipo tem de existir enquanto a instância existir.
+     *
+     * @param source Modelo já carregado (protótipo)
+     * @param transformStore Armazenamento onde a transformação da instância é criada
+     */
+    ObjModel(const ObjModel& source, TransformStore& transformStore);
+
+    /**
+     * @brief Reutiliza as texturas já carregadas com o mesmo caminho (entre modelos diferentes)
+     */
+    static void setTextureSharing(bool enabled) { shareTextures = enabled; }
+
+    /**
+     * @brief Constrói o pacote de desenho numa lista externa (seguro entre threads)
+     *
+     * O programa e a textura do modelo devem ter sido registados antes
+     * com RenderQueue::registerState.
+     *
+     * @param queue Fila que define as vistas e as chaves
+     * @param out Lista que recebe o pacote
+     * @param viewId Índice da vista
+     * @param program ID do programa de shader a utilizar
+     */
+    void record(const RenderQueue& queue, RenderList& out, uint8_t viewId, GLuint program) const;
+
+    /**
+     * @brief Matriz de modelo em cache no TransformStore (válida depois de TransformStore::update)
+     */
+    const glm::mat4& getModelMatrix() const { return transforms.getWorldMatrix(transform); }
+
+    /**
+     * @brief Devolve o material atual (coeficientes de Phong e textura), ou nullptr se não houver
+     */
+    const Material* getMaterial() const;
+
+    // Acesso aos dados da geometria (usados para agrupar modelos num buffer partilhado)
+    const std::vector<float>& getVertexData() const { return shared().interleaved; }
+    const std::vector<unsigned int>& getIndexData() const { return shared().indices; }
+
+    /**
+     * @brief Indica se os vértices só têm posição (esfera com o mapeamento equirretangular das bolas)
+     *
+     * Nesse caso a normal e o UV são calculados no shader (variante
+     * SPHERE_UV) e o VBO só tem os atributos da localização 0.
      */
-    ObjModel(const std::string& path);
+    bool hasSphereVertices() const { return shared().sphereVertices; }
+
+    static constexpr float SEAM_U = 0.765625f; // u do meridiano +X nas texturas PoolBalluv (injetado nos shaders, ver SetShaderDefines)
 
     /**
-     * @brief Renderiza o modelo na cena
-     * @param program ID do programa de shader ativo
-     * @param view Matriz de visualizao da cmera
-     * @param projection Matriz de projeo
+     * @brief Floats por vértice em getVertexData(): 3 (só posição) ou 8 (posição, normal, UV)
      */
-    void render(GLuint program, const glm::mat4& view, const glm::mat4& projection) const;
+    int getVertexStride() const { return shared().sphereVertices ? 3 : 8; }
+    GLuint getDiffuseTexture() const;
+
+    // Instâncias não têm geometria própria (não devem ser agrupadas no multi-draw)
+    bool isInstance() const { return prototype != nullptr; }
+
+    /**
+     * @brief Raio da esfera envolvente no espaço do mundo (centrada na posição do modelo)
+     */
+    float getBoundingRadius() const;
+
+    /**
+     * @brief Raio da esfera envolvente no espaço do objeto (sem escala)
+     */
+    float getLocalRadius() const { return shared().boundingRadius; }
+
+    // Índice do modelo no buffer partilhado do multi-draw indireto (-1 = não agrupado)
+    void setMeshIndex(int index) { meshIndex = index; }
+    int getMeshIndex() const { return shared().meshIndex; }
 
 private:
+    /**
+     * @brief Modelo que contém a geometria e os materiais (o próprio, ou o protótipo da instância)
+     */
+    const ObjModel& shared() const { return prototype ? *prototype : *this; }
+
     /**
      * @brief Carrega e processa um arquivo OBJ
      *
      * Processa:
-     * - Vrtices (v)
+     * - Vértices (v)
      * - Normais (vn)
      * - Coordenadas de textura (vt)
      * - Faces (f)
-     * - Referncias a materiais
+     * - Referências a materiais
      */
     void loadOBJ(const std::string& path);
 
@@ -99,47 +185,80 @@ private:
     void loadMTL(const std::string& path);
 
     /**
-     * @brief Configura os buffers do OpenGL para renderizao
+     * @brief Verifica se a malha é uma esfera centrada na origem com o mapeamento equirretangular das bolas
+     *
+     * Todos os vértices têm de estar à mesma distância da origem, com a
+     * normal na direção da posição, e cada UV tem de coincidir com
+     * u = SEAM_U - atan2(z, x) / 2pi (módulo 1), v = 1/2 + asin(y) / pi.
+     */
+    bool matchesSphereMapping() const;
+
+    /**
+     * @brief Configura os buffers do OpenGL para renderização
      *
      * Cria e configura:
      * - VAO (Vertex Array Object)
      * - VBO (Vertex Buffer Object)
-     * - Atributos de vrtices
+     * - EBO (Element Buffer Object)
+     * - Atributos de vértices
      */
     void install();
 
+    /**
+     * @brief Pacote de desenho do modelo (sem chave)
+     */
+    RenderPacket makePacket(GLuint program) const;
+
     /**
      * @brief Carrega uma imagem como textura na GPU
      * @param filename Caminho do arquivo de imagem
-     * @param texID ID da textura no OpenGL (sada)
+     * @param texID ID da textura no OpenGL (saída)
      */
     void loadTexture(const std::string& filename, GLuint& texID);
 
     // Dados da geometria do modelo
-    std::vector<glm::vec3> vertices;         // Posies dos vrtices
+    std::vector<glm::vec3> vertices;         // Posições dos vértices
     std::vector<glm::vec3> normals;          // Vetores normais
     std::vector<glm::vec2> texcoords;        // Coordenadas de textura (UV)
 
-    // ndices para construo das faces
-    std::vector<unsigned int> vertexIndices;    // ndices dos vrtices
-    std::vector<unsigned int> texcoordIndices;  // ndices das coords de textura
-    std::vector<unsigned int> normalIndices;    // ndices das normais
+    // Índices para construção das faces
+    std::vector<unsigned int> vertexIndices;    // Índices dos vértices
+    std::vector<unsigned int> texcoordIndices;  // Índices das coords de textura
+    std::vector<unsigned int> normalIndices;    // Índices das normais
 
     /**
      * Vetor que combina todos os dados em um formato adequado para o OpenGL
-     * Estrutura: [px,py,pz, nx,ny,nz, u,v] para cada vrtice
+     * Estrutura: [px,py,pz, nx,ny,nz, u,v] para cada vértice único
      * onde:
-     * - px,py,pz: posio do vrtice
-     * - nx,ny,nz: normal do vrtice
+     * - px,py,pz: posição do vértice
+     * - nx,ny,nz: normal do vértice
      * - u,v: coordenada de textura
+     * Nas esferas (sphereVertices) só [px,py,pz].
      */
     std::vector<float> interleaved;
+    bool sphereVertices = false;  // Vértices só com posição (ver hasSphereVertices)
+
+    // Índices dos triângulos no vetor intercalado (vértices repetidos são partilhados)
+    std::vector<unsigned int> indices;
 
     // Gerenciamento de materiais
     std::map<std::string, Material> materials;  // Materiais indexados por nome
     std::string currentMaterialName;            // Material atual em uso
 
     // Identificadores OpenGL
-    GLuint VAO;  // Vertex Array Object: configurao dos atributos
-    GLuint VBO;  // Vertex Buffer Object: dados dos vrtices
+    GLuint VAO;  // Vertex Array Object: configuração dos atributos
+    GLuint VBO;  // Vertex Buffer Object: dados dos vértices
+    GLuint EBO;  // Element Buffer Object: índices dos triângulos
+
+    int meshIndex = -1; // Posição no MultiDrawBatch (-1 = desenho individual)
+
+    float boundingRadius = 0.0f; // Distância máxima de um vértice à origem do modelo
+
+    TransformStore& transforms;  // Armazenamento partilhado das transformações
+    TransformHandle transform;   // Transformação deste modelo
+
+    const ObjModel* prototype = nullptr; // Modelo partilhado por esta instância (nullptr = modelo próprio)
+
+    static bool shareTextures;                          // Ver setTextureSharing
+    static std::map<std::string, GLuint> textureCache;  // Caminho -> textura já carregada
 };
\ No newline at end of file
@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Implementação do Multi-Draw Indireto
+ *
+ * Agrupa a geometria e as texturas dos modelos em recursos partilhados
+ * para que todos os desenhos visíveis de uma vista sejam submetidos com
+ * uma única chamada glMultiDrawElementsIndirect.
+ ***********************************************************************/
+
+#include "multidraw.h"
+#include "model.h"
+#include "shader.h"
+#include "gpumemory.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/**
+ * @brief Conclui e apaga um programa pedido que acabou por não ser usado
+ */
+static void discardProgram(GLuint requested) {
+    const GLuint unused = requested ? FinishProgram(requested) : 0;
+    if (unused) glDeleteProgram(unused);
+}
+
+void MultiDrawBatch::destroy() {
+    bindless.release();
+    discardProgram(pendingProgram);
+    discardProgram(pendingDepthProgram);
+    pendingProgram = pendingDepthProgram = 0;
+
+    if (vao) glDeleteVertexArrays(1, &vao);
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+    if (indirectBuffer) glDeleteBuffers(1, &indirectBuffer);
+    if (drawDataBuffer) glDeleteBuffers(1, &drawDataBuffer);
+    if (materialBuffer) glDeleteBuffers(1, &materialBuffer);
+    if (textureArray) glDeleteTextures(1, &textureArray);
+    if (program) glDeleteProgram(program);
+    if (depthProgram) glDeleteProgram(depthProgram);
+    vao = vbo = ebo = indirectBuffer = drawDataBuffer = materialBuffer = textureArray = 0;
+    program = depthProgram = 0;
+    drawBaseLoc = depthDrawBaseLoc = -1;
+
+    GpuMemory::addBuffer(-(sharedBufferBytes + ownBufferBytes));
+    GpuMemory::addTexture(-textureArrayBytes);
+    sharedBufferBytes = ownBufferBytes = textureArrayBytes = 0;
+
+    meshes.clear();
+    commands.clear();
+    drawData.clear();
+    frameBuffer = 0;
+    ready = false;
+}
+
+/**
+ * @brief Copia as texturas difusas dos modelos para um array de texturas
+ *
+ * Todas as texturas têm de ter as mesmas dimensões e formato; a cópia é
+ * feita na GPU, nível de mipmap a nível, com glCopyImageSubData.
+ *
+ * @return false se alguma textura estiver em falta ou for incompatível,
+ *         ou se houver mais modelos do que camadas permitidas
+ */
+bool MultiDrawBatch::buildTextureArray(const std::vector<ObjModel*>& models) {
+    GLint width = 0, height = 0, format = 0;
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (static_cast<GLint>(models.size()) > maxLayers) {
+        std::cerr << "Multi-draw: mais modelos do que camadas no array de texturas (" << maxLayers << "), a usar desenho individual" << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < models.size(); ++i) {
+        const GLuint tex = models[i]->getDiffuseTexture();
+        if (!tex) return false;
+
+        GLint w, h, f;
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &f);
+
+        if (i == 0) {
+            width = w; height = h; format = f;
+        }
+        else if (w != width || h != height || f != format) {
+            std::cerr << "Multi-draw: texturas com dimensoes diferentes, a usar desenho individual" << std::endl;
+            return false;
+        }
+    }
+
+    const GLsizei levels = static_cast<GLsizei>(std::floor(std::log2(std::max(width, height)))) + 1;
+    const GLsizei layers = static_cast<GLsizei>(models.size());
+
+    glGenTextures(1, &textureArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, format, width, height, layers);
+    textureArrayBytes = GpuMemory::imageBytes(width, height, layers, format == GL_RGBA8 ? 4 : 3, levels);
+    GpuMemory::addTexture(textureArrayBytes);
+
+    for (GLsizei layer = 0; layer < layers; ++layer) {
+        const GLuint tex = models[layer]->getDiffuseTexture();
+        for (GLsizei level = 0; level < levels; ++level) {
+            glCopyImageSubData(
+                tex, GL_TEXTURE_2D, level, 0, 0, 0,
+                textureArray, GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+                std::max(1, width >> level), std::max(1, height >> level), 1);
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return true;
+}
+
+/**
+ * @brief Pede a compilação do programa de multi-draw (sem esperar pelo driver)
+ */
+static GLuint issueProgram(bool useBindless, bool sphereVertices) {
+    ShaderInfo shaders[] = {
+        { GL_VERTEX_SHADER,   "shader_mdi.vert" },
+        { GL_FRAGMENT_SHADER, useBindless ? "shader_mdi_bindless.frag" : "shader_mdi.frag" },
+        { GL_FRAGMENT_SHADER, "lighting.frag" },  // Iluminação clustered, partilhada com shader.frag
+        { sphereVertices ? GLenum(GL_FRAGMENT_SHADER) : GLenum(GL_NONE), "sphereuv.frag" },  // UV das esferas, partilhado com shader.frag
+        { GL_NONE, NULL }
+    };
+    return LoadShadersAsync(shaders, sphereVertices ? "#define SPHERE_UV\n" : nullptr);
+}
+
+/**
+ * @brief Pede a compilação do programa de profundidade do multi-draw (o mesmo para todos os formatos de vértices)
+ */
+static GLuint issueDepthProgram() {
+    ShaderInfo shaders[] = {
+        { GL_VERTEX_SHADER,   "shader_mdi.vert" },
+        { GL_FRAGMENT_SHADER, "shader.frag" },  // Variante DEPTH_ONLY: não escreve cor
+        { GL_NONE, NULL }
+    };
+    return LoadShadersAsync(shaders, "#define DEPTH_ONLY\n");
+}
+
+void MultiDrawBatch::requestProgram(bool useBindless, bool sphereVertices) {
+    discardProgram(pendingProgram);
+    pendingProgram = issueProgram(useBindless, sphereVertices);
+    if (!pendingDepthProgram) pendingDepthProgram = issueDepthProgram();
+    pendingBindless = useBindless;
+    pendingSphere = sphereVertices;
+}
+
+/**
+ * @brief Agrupa os modelos em buffers partilhados
+ *
+ * Os vértices e índices de cada modelo são concatenados; cada modelo
+ * guarda o seu firstIndex/baseVertex para gerar os comandos indiretos.
+ */
+bool MultiDrawBatch::build(const std::vector<ObjModel*>& models, bool useBindless) {
+    // Programa pedido antecipadamente com requestProgram() (se houver)
+    GLuint requested = pendingProgram;
+    const bool requestedBindless = pendingBindless;
+    const bool requestedSphere = pendingSphere;
+    const GLuint requestedDepth = pendingDepthProgram;
+    pendingProgram = 0;
+    pendingDepthProgram = 0;
+
+    if (models.empty()) {
+        discardProgram(requested);
+        discardProgram(requestedDepth);
+        return false;
+    }
+
+    // Um só VBO: todos os modelos têm de usar o mesmo formato de vértices
+    const bool sphereVertices = models.front()->hasSphereVertices();
+    for (const ObjModel* model : models) {
+        if (model->hasSphereVertices() != sphereVertices) {
+            std::cerr << "Multi-draw: modelos com formatos de vertices diferentes, a usar desenho individual" << std::endl;
+            discardProgram(requested);
+            discardProgram(requestedDepth);
+            return false;
+        }
+    }
+
+    // Texturas: handles bindless (índice = material) ou array de texturas (índice = camada)
+    if (useBindless) {
+        std::vector<GLuint> textures;
+        for (const ObjModel* model : models) {
+            textures.push_back(model->getDiffuseTexture());
+        }
+        useBindless = bindless.build(textures);
+    }
+    if (!useBindless && !buildTextureArray(models)) {
+        discardProgram(requested);
+        discardProgram(requestedDepth);
+        return false;
+    }
+
+    // Programa que lê os dados por desenho através de gl_DrawID; o pedido
+    // antecipado só serve se o caminho das texturas e o formato dos vértices não tiverem mudado
+    if (requested && (requestedBindless != useBindless || requestedSphere != sphereVertices)) {
+        discardProgram(requested);
+        requested = 0;
+    }
+    program = FinishProgram(requested ? requested : issueProgram(useBindless, sphereVertices));
+    if (!program) {
+        std::cerr << "Multi-draw: falha ao carregar shaders, a usar desenho individual" << std::endl;
+        discardProgram(requestedDepth);
+        bindless.release();
+        return false;
+    }
+
+    // Sem o programa de profundidade, as cópias do pre-pass são desenhadas individualmente
+    depthProgram = FinishProgram(requestedDepth ? requestedDepth : issueDepthProgram());
+    depthDrawBaseLoc = depthProgram ? glGetUniformLocation(depthProgram, "drawBase") : -1;
+    drawBaseLoc = glGetUniformLocation(program, "drawBase");
+    glUseProgram(program);
+    if (!useBindless) {
+        glUniform1i(glGetUniformLocation(program, "texArray"), 0);
+    }
+
+    // Concatena a geometria de todos os modelos
+    std::vector<float> vertexData;
+    std::vector<unsigned int> indexData;
+    meshes.clear();
+    const int floatsPerVertex = models.front()->getVertexStride();
+
+    for (size_t i = 0; i < models.size(); ++i) {
+        const std::vector<float>& vertices = models[i]->getVertexData();
+        const std::vector<unsigned int>& indices = models[i]->getIndexData();
+
+        MeshRange range;
+        range.firstIndex = static_cast<GLuint>(indexData.size());
+        range.indexCount = static_cast<GLuint>(indices.size());
+        range.baseVertex = static_cast<GLint>(vertexData.size() / floatsPerVertex);
+        range.textureLayer = static_cast<GLuint>(i);
+        meshes.push_back(range);
+
+        vertexData.insert(vertexData.end(), vertices.begin(), vertices.end());
+        indexData.insert(indexData.end(), indices.begin(), indices.end());
+        models[i]->setMeshIndex(static_cast<int>(i));
+    }
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferStorage(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), 0);
+
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * sizeof(unsigned int), indexData.data(), 0);
+    sharedBufferBytes = vertexData.size() * sizeof(float) + indexData.size() * sizeof(unsigned int);
+    GpuMemory::addBuffer(sharedBufferBytes);
+
+    // Mesmo layout de ObjModel::install: [px,py,pz, nx,ny,nz, u,v], ou só [px,py,pz] nas esferas
+    const int stride = floatsPerVertex * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    if (!sphereVertices) {
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+    }
+
+    glBindVertexArray(0);
+
+    // Materiais, pela mesma ordem que as texturas (índice = textureLayer)
+    std::vector<MaterialData> materials;
+    for (const ObjModel* model : models) {
+        const Material* material = model->getMaterial();
+        const Material fallback;
+        const Material& phong = material ? *material : fallback;
+        MaterialData data;
+        data.ka = glm::vec4(phong.ka, 0.0f);
+        data.kd = glm::vec4(phong.kd, 0.0f);
+        data.ksNs = glm::vec4(phong.ks, phong.ns);
+        materials.push_back(data);
+    }
+    glGenBuffers(1, &materialBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialBuffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(MaterialData), materials.data(), 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    sharedBufferBytes += materials.size() * sizeof(MaterialData);
+    GpuMemory::addBuffer(materials.size() * sizeof(MaterialData));
+
+    glGenBuffers(1, &indirectBuffer);
+    glGenBuffers(1, &drawDataBuffer);
+
+    ready = true;
+    return true;
+}
+
+void MultiDrawBatch::begin() {
+    commands.clear();
+    drawData.clear();
+}
+
+GLuint MultiDrawBatch::add(int mesh, const glm::mat4& mvp, const glm::mat4& modelView) {
+    const MeshRange& range = meshes[mesh];
+
+    DrawElementsIndirectCommand command;
+    command.count = range.indexCount;
+    command.instanceCount = 1;
+    command.firstIndex = range.firstIndex;
+    command.baseVertex = range.baseVertex;
+    command.baseInstance = 0;
+    commands.push_back(command);
+
+    DrawData data = {};
+    data.mvp = mvp;
+    data.modelView = modelView;
+    data.textureLayer = range.textureLayer;
+    drawData.push_back(data);
+
+    return static_cast<GLuint>(commands.size() - 1);
+}
+
+/**
+ * @brief Envia o buffer de comandos do frame e os dados por desenho
+ *
+ * Com um StreamBuffer, comandos e DrawData são copiados para a região do
+ * frame no mapeamento persistente. Sem ele (ou se a região não tiver
+ * espaço), os buffers próprios são realocados com glBufferData para que
+ * o driver não tenha de esperar pelo frame anterior.
+ */
+void MultiDrawBatch::upload() {
+    if (commands.empty()) return;
+
+    const GLsizeiptr commandBytes = commands.size() * sizeof(DrawElementsIndirectCommand);
+    drawDataSize = drawData.size() * sizeof(DrawData);
+
+    if (streamBuffer && streamBuffer->isReady()) {
+        // Os deslocamentos indiretos só precisam de 4 bytes; o SSBO segue o alinhamento do driver
+        const StreamAllocation commandSlice = streamBuffer->allocate(commandBytes, sizeof(GLuint));
+        const StreamAllocation dataSlice = streamBuffer->allocate(drawDataSize, streamBuffer->getStorageAlignment());
+        if (commandSlice.data && dataSlice.data) {
+            std::memcpy(commandSlice.data, commands.data(), commandBytes);
+            std::memcpy(dataSlice.data, drawData.data(), drawDataSize);
+            frameBuffer = streamBuffer->getBuffer();
+            commandOffset = commandSlice.offset;
+            drawDataOffset = dataSlice.offset;
+            return;
+        }
+    }
+
+    frameBuffer = 0;
+    commandOffset = 0;
+    drawDataOffset = 0;
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+        commands.size() * sizeof(DrawElementsIndirectCommand),
+        commands.data(), GL_STREAM_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER,
+        drawData.size() * sizeof(DrawData),
+        drawData.data(), GL_STREAM_DRAW);
+
+    // Os dois buffers passam a ter exatamente o tamanho deste frame
+    GpuMemory::addBuffer(commandBytes + drawDataSize - ownBufferBytes);
+    ownBufferBytes = commandBytes + drawDataSize;
+}
+
+void MultiDrawBatch::draw(GLuint first, GLsizei count, bool depthOnly) {
+    if (count <= 0) return;
+
+    glUseProgram(depthOnly ? depthProgram : program);
+    glBindVertexArray(vao);
+    if (frameBuffer) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, frameBuffer);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, frameBuffer, drawDataOffset, drawDataSize);
+    }
+    else {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, drawDataBuffer);
+    }
+
+    // O pre-pass só precisa das matrizes; a cor lê também os materiais e as texturas
+    if (!depthOnly) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, materialBuffer);
+        if (bindless.isReady()) {
+            // Os handles já são residentes: basta a tabela, nenhuma textura é ligada
+            bindless.bind(1);
+        }
+        else {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        }
+    }
+
+    // gl_DrawID recomeça em 0 em cada chamada; drawBase indica a fatia do SSBO
+    glUniform1ui(depthOnly ? depthDrawBaseLoc : drawBaseLoc, first);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+        (const void*)(commandOffset + first * sizeof(DrawElementsIndirectCommand)),
+        count, 0);
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - vector: listas de comandos e dados por desenho
+ * - GL/glew: buffers, texturas e chamadas de desenho
+ * - glm: matrizes enviadas ao shader por desenho
+ */
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "bindless.h"
+#include "streambuffer.h"
+
+class ObjModel;
+
+/**
+ * @brief Comando de desenho indireto, com o layout exigido pelo OpenGL
+ */
+struct DrawElementsIndirectCommand {
+    GLuint count;          // Número de índices
+    GLuint instanceCount;  // Número de instâncias (sempre 1)
+    GLuint firstIndex;     // Primeiro índice no EBO partilhado
+    GLint baseVertex;      // Deslocamento somado a cada índice
+    GLuint baseInstance;   // Não utilizado
+};
+
+/**
+ * @brief Dados por desenho lidos pelo shader através de gl_DrawID (layout std430)
+ */
+struct DrawData {
+    glm::mat4 mvp;             // Matriz Model-View-Projection
+    glm::mat4 modelView;       // Matriz Model-View (iluminação no espaço da vista)
+    GLuint textureLayer;       // Camada no array de texturas, ou índice do material bindless
+    GLuint padding[3];         // Alinhamento a 16 bytes
+};
+
+/**
+ * @brief Coeficientes de Phong de um modelo agrupado, lidos pelo shader (layout std430)
+ */
+struct MaterialData {
+    glm::vec4 ka;    // xyz
+    glm::vec4 kd;    // xyz
+    glm::vec4 ksNs;  // xyz: ks, w: ns
+};
+
+/**
+ * @brief Submissão de vários modelos com uma única chamada glMultiDrawElementsIndirect
+ *
+ * Todos os modelos agrupados partilham um VAO, um VBO e um EBO (e por
+ * isso o mesmo formato de vértices). As suas
+ * texturas são acedidas por handles bindless, quando ARB_bindless_texture
+ * existe, ou copiadas para um GL_TEXTURE_2D_ARRAY; os materiais ficam num
+ * SSBO com o mesmo índice. Em cada frame é
+ * construído um único buffer de comandos indiretos (um comando por
+ * desenho visível) e um SSBO com os dados por desenho; cada vista emite
+ * depois uma chamada que referencia uma fatia contígua desses buffers.
+ *
+ * Requer GL 4.3 e gl_DrawID (GL 4.6 ou ARB_shader_draw_parameters);
+ * quando não está disponível, os modelos continuam a ser desenhados
+ * individualmente pela RenderQueue.
+ */
+class MultiDrawBatch {
+public:
+    ~MultiDrawBatch() { destroy(); }
+
+    /**
+     * @brief Liberta os buffers, as texturas e os programas (chamar antes de destruir o contexto)
+     */
+    void destroy();
+
+    /**
+     * @brief Agrupa os modelos nos buffers partilhados e carrega o programa
+     * @param models Modelos a agrupar (recebem o seu índice via setMeshIndex)
+     * @param useBindless Usa handles bindless em vez do array de texturas
+     * @return true se o caminho de multi-draw ficou pronto a usar
+     */
+    bool build(const std::vector<ObjModel*>& models, bool useBindless);
+
+    /**
+     * @brief Pede já a compilação do programa, para que decorra durante o carregamento dos modelos
+     * @param useBindless Caminho de texturas que build() deverá usar
+     * @param sphereVertices Formato de vértices esperado (ObjModel::hasSphereVertices)
+     */
+    void requestProgram(bool useBindless, bool sphereVertices);
+
+    /**
+     * @brief Descarta os desenhos do frame anterior
+     */
+    void begin();
+
+    /**
+     * @brief Acrescenta um desenho ao frame atual
+     * @param mesh Índice do modelo devolvido por ObjModel::getMeshIndex
+     * @param mvp Matriz Model-View-Projection do desenho
+     * @param modelView Matriz Model-View do desenho
+     * @return Posição do desenho no buffer de comandos
+     */
+    GLuint add(int mesh, const glm::mat4& mvp, const glm::mat4& modelView);
+
+    /**
+     * @brief Usa um buffer circular persistente para os dados por frame
+     * @param stream Buffer já inicializado, ou nullptr para voltar ao glBufferData
+     */
+    void setStreamBuffer(StreamBuffer* stream) { streamBuffer = stream; }
+
+    /**
+     * @brief Envia os comandos e os dados por desenho para a GPU (uma vez por frame)
+     */
+    void upload();
+
+    /**
+     * @brief Desenha uma fatia contígua dos comandos do frame
+     * @param first Primeiro comando
+     * @param count Número de comandos
+     * @param depthOnly Usa o programa do pre-pass de profundidade (sem texturas nem materiais)
+     */
+    void draw(GLuint first, GLsizei count, bool depthOnly = false);
+
+    bool isReady() const { return ready; }
+    bool hasDepthProgram() const { return depthProgram != 0; }
+    bool isBindless() const { return bindless.isReady(); }
+    GLuint getProgram() const { return program; }
+
+private:
+    /**
+     * @brief Intervalo de um modelo dentro dos buffers partilhados
+     */
+    struct MeshRange {
+        GLuint firstIndex;
+        GLuint indexCount;
+        GLint baseVertex;
+        GLuint textureLayer;
+    };
+
+    bool buildTextureArray(const std::vector<ObjModel*>& models);
+
+    bool ready = false;
+    GLuint program = 0;          // Programa que lê DrawData[gl_DrawID]
+    GLuint pendingProgram = 0;   // Programa pedido por requestProgram(), ainda por concluir
+    GLuint depthProgram = 0;     // Variante DEPTH_ONLY, para o pre-pass de profundidade
+    GLuint pendingDepthProgram = 0;
+    bool pendingBindless = false;
+    bool pendingSphere = false;
+    GLint drawBaseLoc = -1;      // Uniform com o primeiro desenho da chamada atual
+    GLint depthDrawBaseLoc = -1;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    GLuint indirectBuffer = 0;   // GL_DRAW_INDIRECT_BUFFER com os comandos do frame
+    GLuint drawDataBuffer = 0;   // SSBO com DrawData por desenho
+    GLuint materialBuffer = 0;   // SSBO com MaterialData por modelo (fixo)
+    GLuint textureArray = 0;     // Texturas difusas dos modelos agrupados (sem bindless)
+    BindlessMaterials bindless;  // Handles das texturas difusas (com bindless)
+
+    StreamBuffer* streamBuffer = nullptr;  // Buffer circular do frame (opcional)
+    GLuint frameBuffer = 0;                // Buffer com os dados do frame atual (stream ou próprio)
+    GLintptr commandOffset = 0;            // Deslocamento dos comandos nesse buffer
+    GLintptr drawDataOffset = 0;           // Deslocamento dos DrawData nesse buffer
+    GLsizeiptr drawDataSize = 0;
+    GLsizeiptr ownBufferBytes = 0;         // Bytes alocados nos buffers próprios (sem stream)
+    long long sharedBufferBytes = 0;       // Bytes do VBO, EBO e materiais (GpuMemory)
+    long long textureArrayBytes = 0;       // Bytes do array de texturas (GpuMemory)
+
+    std::vector<MeshRange> meshes;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<DrawData> drawData;
+};
@@ -0,0 +1,14 @@
+#version 330 core
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Atlas de glifos: cobertura no canal vermelho (a célula branca serve os retângulos)
+uniform sampler2D atlas;
+
+out vec4 fragOutput;
+
+void main() {
+    float coverage = texture(atlas, fragTexCoord).r;
+    fragOutput = vec4(fragColor.rgb, fragColor.a * coverage);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 330 core
+
+// Painel de desempenho: posições em pixels, com a origem no canto superior esquerdo
+layout(location = 0) in vec2 vPosition;
+layout(location = 1) in vec2 vTexCoord;
+layout(location = 2) in vec4 vColor;     // RGBA8 normalizado
+
+uniform vec2 screenSize;
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main() {
+    vec2 ndc = vPosition / screenSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    fragTexCoord = vTexCoord;
+    fragColor = vColor;
+}
\ No newline at end of file
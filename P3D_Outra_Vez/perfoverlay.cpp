@@ -0,0 +1,361 @@
+/***********************************************************************
+ * Implementação do Painel de Desempenho
+ *
+ * Texto e gráfico são convertidos em quads num único buffer de vértices
+ * e desenhados com uma chamada, amostrando um atlas de glifos 5x7.
+ ***********************************************************************/
+
+#include "perfoverlay.h"
+#include "shader.h"
+#include "gpumemory.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+
+/**
+ * Atlas: células de 8x8 texels em 16 colunas; a célula i contém o
+ * carácter 32 + i (do espaço a '_'), e a célula GLYPH_COUNT é branca.
+ */
+static constexpr int GLYPH_COUNT = 64;
+static constexpr int CELL = 8;
+static constexpr int ATLAS_COLUMNS = 16;
+static constexpr int ATLAS_WIDTH = CELL * ATLAS_COLUMNS;
+static constexpr int ATLAS_HEIGHT = CELL * 8;
+static constexpr int GLYPH_WIDTH = 5;
+static constexpr int GLYPH_HEIGHT = 7;
+
+static constexpr float TEXT_SCALE = 2.0f;                     // Pixels do ecrã por texel do glifo
+static constexpr float TEXT_ADVANCE = 6.0f * TEXT_SCALE;      // Largura de um carácter com espaçamento
+static constexpr float LINE_HEIGHT = 9.0f * TEXT_SCALE;
+static constexpr float GRAPH_MAX_MS = 33.3f;                  // Topo do gráfico
+static constexpr float BUDGET_MS = 16.6f;                     // Linha de referência (60 Hz)
+
+/**
+ * Glifos 5x7 dos caracteres 32..95: uma linha por byte, de cima para
+ * baixo, com o bit 4 na coluna da esquerda. As minúsculas são
+ * desenhadas com o glifo da maiúscula.
+ */
+static const uint8_t FONT_5X7[GLYPH_COUNT][GLYPH_HEIGHT] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // espaco
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, // !
+    { 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 }, // "
+    { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A }, // #
+    { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 }, // $
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // %
+    { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D }, // &
+    { 0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 }, // '
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // (
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // )
+    { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 }, // *
+    { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 }, // +
+    { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 }, // ,
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // -
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // .
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // /
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // 0
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 1
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // 2
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 3
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // 4
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 5
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // 6
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // 8
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 9
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // :
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 }, // ;
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, // <
+    { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 }, // =
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, // >
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // ?
+    { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E }, // @
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // A
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // B
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // C
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // D
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // E
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // F
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // G
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // H
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // I
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // J
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // K
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // L
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // M
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // N
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // O
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // P
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // Q
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // R
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // S
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // T
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // U
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // V
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // W
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // X
+    { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 }, // Y
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // Z
+    { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E }, // [
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, // \\ (barra invertida)
+    { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E }, // ]
+    { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 }, // ^
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, // _
+};
+
+/**
+ * @brief Empacota uma cor RGBA8 pela ordem dos bytes em memória
+ */
+static uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return static_cast<uint32_t>(r) | (static_cast<uint32_t>(g) << 8) |
+        (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(a) << 24);
+}
+
+bool PerfOverlay::init(GLsizei screenWidth, GLsizei screenHeight) {
+    destroy();
+    width = screenWidth;
+    height = screenHeight;
+
+    // O programa é concluído no primeiro draw(); até lá o driver compila em paralelo
+    ShaderInfo shaders[] = {
+        { GL_VERTEX_SHADER,   "overlay.vert" },
+        { GL_FRAGMENT_SHADER, "overlay.frag" },
+        { GL_NONE, NULL }
+    };
+    program = LoadShadersAsync(shaders, nullptr);
+    programFinished = false;
+
+    // Rasteriza os glifos no atlas
+    std::vector<uint8_t> texels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+    for (int glyph = 0; glyph <= GLYPH_COUNT; ++glyph) {
+        const int cellX = (glyph % ATLAS_COLUMNS) * CELL;
+        const int cellY = (glyph / ATLAS_COLUMNS) * CELL;
+        for (int row = 0; row < CELL; ++row) {
+            for (int col = 0; col < CELL; ++col) {
+                bool set;
+                if (glyph == GLYPH_COUNT) {
+                    set = true;
+                }
+                else {
+                    set = row < GLYPH_HEIGHT && col < GLYPH_WIDTH &&
+                        ((FONT_5X7[glyph][row] >> (GLYPH_WIDTH - 1 - col)) & 1);
+                }
+                texels[(cellY + row) * ATLAS_WIDTH + cellX + col] = set ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GpuMemory::addTexture(GpuMemory::imageBytes(ATLAS_WIDTH, ATLAS_HEIGHT, 1, 1));
+
+    // Buffer de vértices (a capacidade é ajustada no primeiro draw)
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, u));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return atlas != 0;
+}
+
+void PerfOverlay::destroy() {
+    if (program && !programFinished) program = FinishProgram(program);
+    if (program) glDeleteProgram(program);
+    if (atlas) {
+        glDeleteTextures(1, &atlas);
+        GpuMemory::addTexture(-GpuMemory::imageBytes(ATLAS_WIDTH, ATLAS_HEIGHT, 1, 1));
+    }
+    if (vbo) {
+        glDeleteBuffers(1, &vbo);
+        GpuMemory::addBuffer(-static_cast<long long>(vboBytes));
+    }
+    if (vao) glDeleteVertexArrays(1, &vao);
+    program = atlas = vbo = vao = 0;
+    programFinished = false;
+    vboBytes = 0;
+}
+
+/**
+ * @brief Conclui o programa pedido em init() e obtém os uniforms
+ */
+bool PerfOverlay::finishProgram() {
+    if (!programFinished) {
+        programFinished = true;
+        program = program ? FinishProgram(program) : 0;
+        if (program) {
+            screenSizeLoc = glGetUniformLocation(program, "screenSize");
+            glProgramUniform1i(program, glGetUniformLocation(program, "atlas"), 0);
+        }
+        else {
+            std::cerr << "Painel de desempenho: falha ao carregar shaders" << std::endl;
+        }
+    }
+    return program != 0;
+}
+
+void PerfOverlay::beginFrame(double nowSeconds) {
+    if (lastFrameStart > 0.0) {
+        history[historyNext] = static_cast<float>((nowSeconds - lastFrameStart) * 1000.0);
+        historyNext = (historyNext + 1) % HISTORY;
+        if (historyCount < HISTORY) ++historyCount;
+    }
+    lastFrameStart = nowSeconds;
+}
+
+double PerfOverlay::getPercentile(double fraction) const {
+    if (historyCount == 0) return 0.0;
+
+    sorted.assign(history, history + historyCount);
+    const size_t rank = static_cast<size_t>(fraction * (historyCount - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+void PerfOverlay::addQuad(float x, float y, float w, float h, float u0, float v0, float u1, float v1, uint32_t color) {
+    const Vertex topLeft = { x, y, u0, v0, color };
+    const Vertex topRight = { x + w, y, u1, v0, color };
+    const Vertex bottomLeft = { x, y + h, u0, v1, color };
+    const Vertex bottomRight = { x + w, y + h, u1, v1, color };
+    vertices.push_back(topLeft);
+    vertices.push_back(bottomLeft);
+    vertices.push_back(topRight);
+    vertices.push_back(topRight);
+    vertices.push_back(bottomLeft);
+    vertices.push_back(bottomRight);
+}
+
+void PerfOverlay::addRect(float x, float y, float w, float h, uint32_t color) {
+    // Centro da célula branca: todos os texels amostrados têm cobertura 1
+    const float u = ((GLYPH_COUNT % ATLAS_COLUMNS) * CELL + CELL * 0.5f) / ATLAS_WIDTH;
+    const float v = ((GLYPH_COUNT / ATLAS_COLUMNS) * CELL + CELL * 0.5f) / ATLAS_HEIGHT;
+    addQuad(x, y, w, h, u, v, u, v, color);
+}
+
+void PerfOverlay::addText(float x, float y, const char* text, uint32_t color) {
+    for (const char* c = text; *c; ++c, x += TEXT_ADVANCE) {
+        int ch = *c;
+        if (ch >= 'a' && ch <= 'z') ch -= 'a' - 'A';
+        if (ch <= ' ' || ch >= ' ' + GLYPH_COUNT) continue;
+
+        const int glyph = ch - ' ';
+        const float u0 = static_cast<float>((glyph % ATLAS_COLUMNS) * CELL) / ATLAS_WIDTH;
+        const float v0 = static_cast<float>((glyph / ATLAS_COLUMNS) * CELL) / ATLAS_HEIGHT;
+        const float u1 = u0 + static_cast<float>(GLYPH_WIDTH) / ATLAS_WIDTH;
+        const float v1 = v0 + static_cast<float>(GLYPH_HEIGHT) / ATLAS_HEIGHT;
+        addQuad(x, y, GLYPH_WIDTH * TEXT_SCALE, GLYPH_HEIGHT * TEXT_SCALE, u0, v0, u1, v1, color);
+    }
+}
+
+/**
+ * @brief Escreve um tempo de GPU, ou "--" se ainda não foi medido
+ */
+static void formatGpuMs(char* out, size_t size, const char* label, double ms) {
+    if (ms < 0.0) std::snprintf(out, size, "%s --", label);
+    else std::snprintf(out, size, "%s %.2f MS", label, ms);
+}
+
+void PerfOverlay::draw(const PerfCounters& counters, GLuint framebuffer) {
+    if (!finishProgram()) return;
+
+    vertices.clear();
+    const uint32_t white = rgba(255, 255, 255);
+    const uint32_t grey = rgba(170, 170, 170);
+    const float margin = 8.0f;
+    const float graphHeight = 60.0f;
+    const float panelWidth = 27 * TEXT_ADVANCE + 2 * margin;
+    const float panelHeight = 7 * LINE_HEIGHT + graphHeight + 3 * margin;
+
+    addRect(0.0f, 0.0f, panelWidth, panelHeight, rgba(0, 0, 0, 170));
+
+    // Texto
+    char line[64];
+    float y = margin;
+    const double lastMs = historyCount ? history[(historyNext + HISTORY - 1) % HISTORY] : 0.0;
+    std::snprintf(line, sizeof(line), "FRAME %.1f MS %.0f FPS", lastMs, lastMs > 0.0 ? 1000.0 / lastMs : 0.0);
+    addText(margin, y, line, white);
+    y += LINE_HEIGHT;
+
+    std::snprintf(line, sizeof(line), "P50 %.1f P95 %.1f P99 %.1f", getPercentile(0.50), getPercentile(0.95), getPercentile(0.99));
+    addText(margin, y, line, white);
+    y += LINE_HEIGHT;
+
+    if (counters.triangles >= 10000) {
+        std::snprintf(line, sizeof(line), "DRAWS %u TRIS %.1fK", counters.drawCalls, counters.triangles / 1000.0);
+    }
+    else {
+        std::snprintf(line, sizeof(line), "DRAWS %u TRIS %llu", counters.drawCalls, counters.triangles);
+    }
+    addText(margin, y, line, white);
+    y += LINE_HEIGHT;
+
+    std::snprintf(line, sizeof(line), "TEX %.1f MB BUF %.1f MB",
+        counters.textureBytes / (1024.0 * 1024.0), counters.bufferBytes / (1024.0 * 1024.0));
+    addText(margin, y, line, white);
+    y += LINE_HEIGHT;
+
+    formatGpuMs(line, sizeof(line), "GPU", counters.gpuFrameMs);
+    addText(margin, y, line, grey);
+    y += LINE_HEIGHT;
+    formatGpuMs(line, sizeof(line), "PRINCIPAL", counters.mainPassMs);
+    addText(margin, y, line, grey);
+    y += LINE_HEIGHT;
+    formatGpuMs(line, sizeof(line), "MINIMAPA", counters.minimapPassMs);
+    addText(margin, y, line, grey);
+    y += LINE_HEIGHT + margin;
+
+    // Gráfico: uma barra por frame, do mais antigo (esquerda) para o mais recente
+    const float barWidth = (panelWidth - 2 * margin) / HISTORY;
+    const float graphBottom = y + graphHeight;
+    addRect(margin, y, panelWidth - 2 * margin, graphHeight, rgba(40, 40, 40, 200));
+    for (int i = 0; i < historyCount; ++i) {
+        const float ms = history[(historyNext + HISTORY - historyCount + i) % HISTORY];
+        const float barHeight = std::min(ms / GRAPH_MAX_MS, 1.0f) * graphHeight;
+        const uint32_t color = ms <= BUDGET_MS ? rgba(80, 200, 80) : ms <= 2 * BUDGET_MS ? rgba(230, 200, 60) : rgba(230, 70, 60);
+        addRect(margin + (HISTORY - historyCount + i) * barWidth, graphBottom - barHeight, barWidth, barHeight, color);
+    }
+    addRect(margin, graphBottom - BUDGET_MS / GRAPH_MAX_MS * graphHeight, panelWidth - 2 * margin, 1.0f, rgba(255, 255, 255, 160));
+
+    // Reescreve o buffer (orfanado, para não esperar pelo frame anterior) e desenha tudo de uma vez
+    const GLsizeiptr bytes = static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex));
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (bytes > vboBytes) {
+        GpuMemory::addBuffer(bytes * 2 - vboBytes);
+        vboBytes = bytes * 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, vboBytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(program);
+    glUniform2f(screenSizeLoc, static_cast<float>(width), static_cast<float>(height));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    glBindVertexArray(0);
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: cor de cada vértice empacotada em 32 bits
+ * - vector: vértices do frame e cópia ordenada do histórico
+ * - GL/glew: textura do atlas, buffer dinâmico e programa
+ */
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+
+/**
+ * @brief Valores mostrados pelo painel, recolhidos pela aplicação em cada frame
+ *
+ * Os tempos de GPU negativos indicam que o scope ainda não foi medido.
+ */
+struct PerfCounters {
+    unsigned int drawCalls = 0;       // Chamadas de desenho da fila (sem o painel)
+    unsigned long long triangles = 0; // Triângulos submetidos
+    long long textureBytes = 0;       // Texturas e renderbuffers alocados
+    long long bufferBytes = 0;        // Buffers alocados
+    double gpuFrameMs = -1.0;         // Frame completo na GPU
+    double mainPassMs = -1.0;         // Vista principal
+    double minimapPassMs = -1.0;      // Vista do minimapa (só quando é atualizado)
+};
+
+/**
+ * @brief Painel de desempenho desenhado por cima da imagem final
+ *
+ * Mostra o tempo de frame (gráfico dos últimos frames e percentis), as
+ * chamadas de desenho, os triângulos, a memória de GPU e o tempo de cada
+ * vista. Para não distorcer o que mede, o painel inteiro (fundo, texto e
+ * gráfico) é um único lote de quads: um atlas de glifos 5x7 gerado no
+ * arranque (com uma célula branca para os retângulos), um buffer de
+ * vértices dinâmico reescrito uma vez por frame e uma só chamada
+ * glDrawArrays.
+ *
+ * O histórico de tempos é registado mesmo com o painel escondido, para
+ * que o gráfico esteja completo logo que é mostrado.
+ */
+class PerfOverlay {
+public:
+    static constexpr int HISTORY = 120;  // Frames mostrados no gráfico
+
+    ~PerfOverlay() { destroy(); }
+
+    /**
+     * @brief Cria o atlas e o buffer e pede a compilação do programa
+     * @param screenWidth, screenHeight Dimensões do framebuffer de destino
+     * @return false se o atlas não pôde ser criado
+     */
+    bool init(GLsizei screenWidth, GLsizei screenHeight);
+
+    /**
+     * @brief Liberta os objetos OpenGL do painel
+     */
+    void destroy();
+
+    /**
+     * @brief Regista o início de um frame (o intervalo para o anterior entra no histórico)
+     * @param nowSeconds Instante atual, em segundos
+     */
+    void beginFrame(double nowSeconds);
+
+    /**
+     * @brief Percentil do tempo de frame no histórico
+     * @param fraction Percentil entre 0 e 1 (p.ex. 0.99)
+     * @return Tempo em milissegundos (0 sem histórico)
+     */
+    double getPercentile(double fraction) const;
+
+    /**
+     * @brief Desenha o painel (uma chamada de desenho)
+     * @param counters Valores do frame
+     * @param framebuffer Framebuffer de destino (0 = janela)
+     */
+    void draw(const PerfCounters& counters, GLuint framebuffer);
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+private:
+    /**
+     * @brief Vértice do painel: posição em pixels (origem no canto superior esquerdo)
+     */
+    struct Vertex {
+        float x, y;
+        float u, v;
+        uint32_t color;  // RGBA8
+    };
+
+    void addQuad(float x, float y, float w, float h, float u0, float v0, float u1, float v1, uint32_t color);
+    void addRect(float x, float y, float w, float h, uint32_t color);
+    void addText(float x, float y, const char* text, uint32_t color);
+    bool finishProgram();
+
+    bool enabled = false;
+    GLsizei width = 0;
+    GLsizei height = 0;
+
+    GLuint program = 0;
+    bool programFinished = false;  // FinishProgram() já foi chamado
+    GLint screenSizeLoc = -1;
+    GLuint atlas = 0;              // Glifos (GL_R8) e célula branca
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLsizeiptr vboBytes = 0;       // Capacidade atual do buffer
+
+    double lastFrameStart = 0.0;
+    float history[HISTORY] = {};   // Tempos de frame (ms), em anel
+    int historyCount = 0;
+    int historyNext = 0;
+
+    std::vector<Vertex> vertices;          // Quads do frame atual
+    mutable std::vector<float> sorted;     // Auxiliar de getPercentile()
+};
\ No newline at end of file
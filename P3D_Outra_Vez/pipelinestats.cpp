@@ -0,0 +1,55 @@
+/***********************************************************************
+ * Implementação das Estatísticas do Pipeline
+ ***********************************************************************/
+
+#include "pipelinestats.h"
+
+void PipelineStatsQuery::init() {
+    destroy();
+    for (int i = 0; i < RING_SIZE; ++i) {
+        glGenQueries(2, queries[i]);
+        pending[i] = false;
+    }
+    current = 0;
+}
+
+void PipelineStatsQuery::destroy() {
+    if (queries[0][0] == 0) return;
+    for (int i = 0; i < RING_SIZE; ++i) {
+        glDeleteQueries(2, queries[i]);
+        queries[i][0] = queries[i][1] = 0;
+    }
+}
+
+void PipelineStatsQuery::begin() {
+    active = false;
+    if (!isReady()) return;
+
+    // Recolhe o resultado antigo desta entrada antes de a reutilizar
+    if (pending[current]) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(queries[current][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            return; // GPU atrasada: salta a medição em vez de esperar
+        }
+
+        glGetQueryObjectui64v(queries[current][0], GL_QUERY_RESULT, &vertexInvocations);
+        glGetQueryObjectui64v(queries[current][1], GL_QUERY_RESULT, &fragmentInvocations);
+        pending[current] = false;
+        ++resultFrames;
+    }
+
+    glBeginQuery(GL_VERTEX_SHADER_INVOCATIONS_ARB, queries[current][0]);
+    glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, queries[current][1]);
+    active = true;
+}
+
+void PipelineStatsQuery::end() {
+    if (!active) return;
+
+    glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB);
+    glEndQuery(GL_VERTEX_SHADER_INVOCATIONS_ARB);
+    pending[current] = true;
+    current = (current + 1) % RING_SIZE;
+    active = false;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - GL/glew: queries de estatísticas do pipeline (GL 4.6 / ARB_pipeline_statistics_query)
+ */
+#include <GL/glew.h>
+
+/**
+ * @brief Contagem de invocações dos shaders de um frame, medida pela GPU
+ *
+ * Usa um anel de queries para que os resultados sejam lidos alguns frames
+ * depois, sem bloquear o CPU à espera da GPU. Serve para confirmar o
+ * efeito do pre-pass de profundidade: com ele ativo, o número de
+ * invocações do fragment shader deve aproximar-se do número de pixels
+ * cobertos pela cena.
+ */
+class PipelineStatsQuery {
+public:
+    ~PipelineStatsQuery() { destroy(); }
+
+    /**
+     * @brief Cria as queries (só deve ser chamado se o contexto as suportar)
+     */
+    void init();
+
+    /**
+     * @brief Liberta as queries
+     */
+    void destroy();
+
+    /**
+     * @brief Começa a medição do frame atual
+     *
+     * Antes de reutilizar uma entrada do anel, lê o seu resultado. Se a
+     * GPU ainda não o tiver disponível, o frame atual não é medido.
+     */
+    void begin();
+
+    /**
+     * @brief Termina a medição do frame atual
+     */
+    void end();
+
+    bool isReady() const { return queries[0][0] != 0; }
+    bool hasResults() const { return resultFrames > 0; }
+
+    GLuint64 getVertexInvocations() const { return vertexInvocations; }
+    GLuint64 getFragmentInvocations() const { return fragmentInvocations; }
+
+private:
+    static const int RING_SIZE = 3;        // Frames de latência até à leitura
+
+    GLuint queries[RING_SIZE][2] = {};     // [frame][0 = vértices, 1 = fragmentos]
+    bool pending[RING_SIZE] = {};          // Entrada à espera de resultado
+    int current = 0;                       // Entrada do frame atual
+    bool active = false;                   // begin() iniciou as queries deste frame
+
+    GLuint64 vertexInvocations = 0;        // Último resultado lido
+    GLuint64 fragmentInvocations = 0;
+    unsigned int resultFrames = 0;         // Número de frames medidos
+};
\ No newline at end of file
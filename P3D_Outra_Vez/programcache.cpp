@@ -0,0 +1,149 @@
+/***********************************************************************
+ * Implementação da Cache de Binários de Programas
+ ***********************************************************************/
+
+#include "programcache.h"
+#include "glcaps.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+    const char MAGIC[4] = { 'P', '3', 'D', 'B' };
+    const uint32_t FILE_VERSION = 1;
+
+    /**
+     * @brief Cabeçalho de cada ficheiro da cache, seguido do binário
+     */
+    struct BinaryHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;            // Repetida no ficheiro para detetar colisões de nome
+        uint32_t binaryFormat;   // Formato devolvido por glGetProgramBinary
+        uint32_t length;         // Bytes do binário
+    };
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+bool ProgramBinaryCache::init(const std::string& path, const GLCapabilities& caps) {
+    enabled = false;
+    if (!caps.programBinary) {
+        return false;
+    }
+
+    directory = path;
+    driver = caps.vendor + "\n" + caps.renderer + "\n" + caps.version;
+
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+
+    enabled = true;
+    return true;
+}
+
+uint64_t ProgramBinaryCache::makeKey(const std::vector<GLenum>& types, const std::vector<std::string>& sources) const {
+    uint64_t key = fnv1a(14695981039346656037ull, driver.data(), driver.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const uint32_t type = i < types.size() ? types[i] : 0;
+        key = fnv1a(key, &type, sizeof(type));
+        key = fnv1a(key, sources[i].data(), sources[i].size());
+    }
+    return key;
+}
+
+std::string ProgramBinaryCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+GLuint ProgramBinaryCache::load(uint64_t key) {
+    if (!enabled) return 0;
+
+    const std::string path = pathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        ++misses;
+        return 0;
+    }
+
+    BinaryHeader header;
+    std::vector<char> binary;
+    bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+        header.version == FILE_VERSION && header.key == key && header.length > 0;
+    if (valid) {
+        binary.resize(header.length);
+        valid = static_cast<bool>(file.read(binary.data(), header.length));
+    }
+    file.close();
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        // O driver pode recusar binários de outra versão: LINK_STATUS fica a falso
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (!program) {
+        // Descarta o ficheiro: será substituído pelo binário recompilado
+        ++rejected;
+        std::remove(path.c_str());
+        return 0;
+    }
+
+    ++hits;
+    return program;
+}
+
+void ProgramBinaryCache::store(uint64_t key, GLuint program) {
+    if (!enabled) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+
+    BinaryHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.key = key;
+    header.binaryFormat = binaryFormat;
+    header.length = static_cast<uint32_t>(length);
+
+    std::ofstream file(pathFor(key), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Cache de programas: nao foi possivel escrever em " << directory << std::endl;
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), length);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: chave de 64 bits
+ * - string, vector: diretório da cache e fontes dos shaders
+ * - GL/glew: glGetProgramBinary/glProgramBinary
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+struct GLCapabilities;
+
+/**
+ * @brief Cache em disco de programas já linkados (glGetProgramBinary)
+ *
+ * Compilar e linkar um programa a partir da fonte pode custar dezenas a
+ * centenas de milissegundos em alguns drivers. Depois do primeiro
+ * arranque, o binário de cada programa é guardado num ficheiro cujo nome
+ * é uma chave de 64 bits calculada a partir das fontes (já com os
+ * #defines da variante) e das strings GL_VENDOR, GL_RENDERER e
+ * GL_VERSION; nos arranques seguintes o programa é recriado com
+ * glProgramBinary.
+ *
+ * Se o ficheiro não existir, estiver corrompido ou o driver o recusar
+ * (p.ex. depois de uma atualização), load() devolve 0 e o programa é
+ * recompilado e guardado de novo, sem intervenção de quem o pediu.
+ */
+class ProgramBinaryCache {
+public:
+    /**
+     * @brief Ativa a cache no diretório indicado (criado se não existir)
+     * @return false se o contexto não suportar binários de programa
+     */
+    bool init(const std::string& directory, const GLCapabilities& caps);
+
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * @brief Calcula a chave de um programa (FNV-1a sobre driver, tipos e fontes)
+     */
+    uint64_t makeKey(const std::vector<GLenum>& types, const std::vector<std::string>& sources) const;
+
+    /**
+     * @brief Recria um programa a partir do binário guardado
+     * @return Programa linkado, ou 0 se não houver binário válido para a chave
+     */
+    GLuint load(uint64_t key);
+
+    /**
+     * @brief Guarda o binário de um programa acabado de linkar
+     *
+     * O programa deve ter sido linkado com GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+     */
+    void store(uint64_t key, GLuint program);
+
+    unsigned int getHits() const { return hits; }
+    unsigned int getMisses() const { return misses; }
+    unsigned int getRejected() const { return rejected; }
+
+private:
+    std::string pathFor(uint64_t key) const;
+
+    bool enabled = false;
+    std::string directory;
+    std::string driver;          // Vendor, renderer e versão: um binário só serve para o mesmo driver
+
+    unsigned int hits = 0;       // Programas carregados do disco
+    unsigned int misses = 0;     // Programas sem binário guardado
+    unsigned int rejected = 0;   // Binários inválidos ou recusados pelo driver
+};
\ No newline at end of file
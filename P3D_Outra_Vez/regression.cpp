@@ -0,0 +1,262 @@
+/***********************************************************************
+ * Implementação da Deteção de Regressões de Desempenho
+ ***********************************************************************/
+
+#include "regression.h"
+#include "jsonvalue.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Métrica do relatório de --bench comparada num cenário
+ */
+struct RegressionMetric {
+    const char* path;        // Caminho no relatório JSON ("frame_ms.p50")
+    double tolerance;        // Tolerância relativa por omissão (0.10 = até 10% pior)
+};
+
+/**
+ * @brief Cenário determinista: argumentos passados ao processo filho e métricas comparadas
+ */
+struct RegressionScenario {
+    const char* name;
+    const char* arguments;
+    int warmupRuns;          // Execuções não medidas (preenchem a cache de programas e a do sistema de ficheiros)
+    std::vector<RegressionMetric> metrics;
+};
+
+// Os contadores de desenho e a memória são exatos para a mesma cena, por isso não têm tolerância
+static const RegressionScenario SCENARIOS[] = {
+    { "cold_load", "--frames 10 --no-program-cache", 0,
+        { { "load_ms", 0.25 } } },
+    { "warm_load", "--frames 10", 1,
+        { { "load_ms", 0.25 } } },
+    { "render_1000", "--frames 1000", 1,
+        { { "frame_ms.p50", 0.10 }, { "frame_ms.p95", 0.15 }, { "frame_ms.p99", 0.25 }, { "gpu_ms", 0.10 },
+          { "draw_calls", 0.0 }, { "triangles", 0.0 }, { "memory.texture_bytes", 0.0 }, { "memory.buffer_bytes", 0.0 } } },
+    { "stress_meshes", "--frames 300 --tables 16 --balls 150 --share meshes", 1,
+        { { "load_ms", 0.25 }, { "frame_ms.p50", 0.10 }, { "frame_ms.p99", 0.25 }, { "gpu_ms", 0.10 },
+          { "draw_calls", 0.0 }, { "memory.buffer_bytes", 0.0 } } },
+    { "stress_unshared", "--frames 300 --tables 4 --balls 15 --share none", 1,
+        { { "load_ms", 0.25 }, { "frame_ms.p50", 0.10 }, { "memory.texture_bytes", 0.0 } } },
+    { "stress_impostors", "--frames 300 --tables 16 --balls 150 --share meshes --impostors", 1,
+        { { "frame_ms.p50", 0.10 }, { "frame_ms.p99", 0.25 }, { "gpu_ms", 0.10 }, { "triangles", 0.0 } } },
+    { "stress_lights", "--frames 300 --tables 4 --balls 15 --lights 256", 1,
+        { { "frame_ms.p50", 0.10 }, { "frame_ms.p99", 0.25 }, { "gpu_ms", 0.10 } } },
+};
+
+static constexpr int DEFAULT_REPEATS = 5;
+static constexpr const char* LOG_PATH = "regression.log";  // Saída dos processos filhos
+
+/**
+ * @brief Mediana de um conjunto de medições
+ */
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5;
+}
+
+/**
+ * @brief Escreve um valor medido: inteiro quando não tem casas decimais (bytes, contadores)
+ */
+static std::string formatValue(double value) {
+    char text[32];
+    if (value == static_cast<double>(static_cast<long long>(value))) {
+        std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+    }
+    else {
+        std::snprintf(text, sizeof(text), "%.3f", value);
+    }
+    return text;
+}
+
+/**
+ * @brief Executa o cenário num processo filho e lê o relatório que ele gravou
+ * @return false se o processo falhou ou o relatório não pôde ser lido
+ */
+static bool runScenario(const std::string& executable, const RegressionScenario& scenario, JsonValue& report) {
+    const std::string reportPath = std::string("regression_") + scenario.name + ".json";
+    std::remove(reportPath.c_str());
+
+    std::string command = "\"" + executable + "\" " + scenario.arguments + " --bench " + reportPath
+        + " >> " + LOG_PATH + " 2>&1";
+#ifdef _WIN32
+    // O cmd.exe retira as primeiras e últimas aspas da linha quando esta começa por aspas
+    command = "\"" + command + "\"";
+#endif
+
+    std::ofstream(LOG_PATH, std::ios::app) << "== " << scenario.name << ": " << scenario.arguments << std::endl;
+    const int status = std::system(command.c_str());
+    if (status != 0) {
+        std::cerr << "Cenario " << scenario.name << " terminou com codigo " << status << " (ver " << LOG_PATH << ")" << std::endl;
+        return false;
+    }
+
+    std::string error;
+    const bool loaded = JsonValue::load(reportPath, report, &error);
+    std::remove(reportPath.c_str());
+    if (!loaded) {
+        std::cerr << "Relatorio de " << scenario.name << " invalido: " << error << std::endl;
+    }
+    return loaded;
+}
+
+/**
+ * @brief Grava a baseline com as medianas medidas, mantendo as tolerâncias já definidas
+ */
+static bool writeBaseline(const std::string& path, const std::string& renderer, int repeats, const JsonValue& previous,
+    const std::vector<std::vector<double>>& medians) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    const JsonValue* previousScenarios = previous.find("scenarios");
+    const size_t scenarioCount = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+    file << std::setprecision(10);
+    file << "{\n";
+    file << "  \"renderer\": "; JsonValue::writeString(file, renderer); file << ",\n";
+    file << "  \"repeats\": " << repeats << ",\n";
+    file << "  \"scenarios\": {\n";
+    for (size_t s = 0; s < scenarioCount; ++s) {
+        const RegressionScenario& scenario = SCENARIOS[s];
+        const JsonValue* previousScenario = previousScenarios ? previousScenarios->find(scenario.name) : nullptr;
+        file << "    \"" << scenario.name << "\": {\n";
+        for (size_t m = 0; m < scenario.metrics.size(); ++m) {
+            const RegressionMetric& metric = scenario.metrics[m];
+            const JsonValue* previousMetric = previousScenario ? previousScenario->find(metric.path) : nullptr;
+            const JsonValue* tolerance = previousMetric ? previousMetric->find("tolerance") : nullptr;
+            file << "      \"" << metric.path << "\": { \"value\": ";
+            if (medians[s][m] >= 0.0) file << medians[s][m];
+            else file << "null";
+            file << ", \"tolerance\": " << (tolerance ? tolerance->asNumber(metric.tolerance) : metric.tolerance) << " }";
+            file << (m + 1 < scenario.metrics.size() ? ",\n" : "\n");
+        }
+        file << "    }" << (s + 1 < scenarioCount ? ",\n" : "\n");
+    }
+    file << "  }\n";
+    file << "}\n";
+    return file.good();
+}
+
+int RegressionHarness::run(const std::string& executable, const std::string& baselinePath, bool updateBaseline) {
+    JsonValue baseline;
+    std::string error;
+    if (!JsonValue::load(baselinePath, baseline, &error) && !updateBaseline) {
+        std::cerr << "Falha ao ler baseline: " << error << std::endl;
+        return -1;
+    }
+
+    const int repeats = std::max(1, static_cast<int>(baseline.find("repeats") ? baseline.find("repeats")->asNumber(DEFAULT_REPEATS) : DEFAULT_REPEATS));
+    const JsonValue* baselineScenarios = baseline.find("scenarios");
+    const std::string baselineRenderer = baseline.find("renderer") ? baseline.find("renderer")->asString() : std::string();
+
+    std::remove(LOG_PATH);
+    std::cout << "Baseline: " << baselinePath << " (" << repeats << " repeticoes por cenario, saida em " << LOG_PATH << ")" << std::endl;
+
+    std::string renderer;
+    int regressions = 0, compared = 0;
+    std::vector<std::vector<double>> medians;
+    for (const RegressionScenario& scenario : SCENARIOS) {
+        std::cout << std::endl << "[" << scenario.name << "] " << scenario.arguments << std::endl;
+
+        JsonValue report;
+        for (int i = 0; i < scenario.warmupRuns; ++i) {
+            if (!runScenario(executable, scenario, report)) return -1;
+        }
+
+        // Cada métrica reúne um valor por repetição
+        std::vector<std::vector<double>> samples(scenario.metrics.size());
+        for (int i = 0; i < repeats; ++i) {
+            if (!runScenario(executable, scenario, report)) return -1;
+            if (renderer.empty() && report.find("renderer")) {
+                renderer = report.find("renderer")->asString();
+            }
+
+            // Tempos e contadores (MDI, bindless, limites do contexto) dependem do renderer:
+            // uma baseline medida noutro não verifica nada
+            if (!updateBaseline && renderer != baselineRenderer) {
+                std::cerr << "Baseline medida em \"" << baselineRenderer << "\", este contexto usa \"" << renderer
+                    << "\": gravar uma baseline para este renderer com --update-baseline" << std::endl;
+                return 1;
+            }
+            for (size_t m = 0; m < scenario.metrics.size(); ++m) {
+                const JsonValue* value = report.findPath(scenario.metrics[m].path);
+                // Valores negativos indicam uma métrica que o contexto não consegue medir (ex.: gpu_ms sem timer queries)
+                if (value && value->isNumber() && value->asNumber() >= 0.0) {
+                    samples[m].push_back(value->asNumber());
+                }
+            }
+        }
+
+        const JsonValue* reference = baselineScenarios ? baselineScenarios->find(scenario.name) : nullptr;
+        medians.emplace_back();
+        for (size_t m = 0; m < scenario.metrics.size(); ++m) {
+            const RegressionMetric& metric = scenario.metrics[m];
+            const double measured = samples[m].empty() ? -1.0 : median(samples[m]);
+            medians.back().push_back(measured);
+
+            std::cout << "  " << std::left << std::setw(22) << metric.path << std::right << std::setw(14)
+                << (measured >= 0.0 ? formatValue(measured) : std::string("n/d"));
+
+            const JsonValue* entry = reference ? reference->find(metric.path) : nullptr;
+            const JsonValue* value = entry ? entry->find("value") : nullptr;
+            if (measured < 0.0 || !value || !value->isNumber()) {
+                std::cout << "   sem referencia" << std::endl;
+                continue;
+            }
+
+            const double expected = value->asNumber();
+            const JsonValue* toleranceValue = entry->find("tolerance");
+            const double tolerance = toleranceValue ? toleranceValue->asNumber(metric.tolerance) : metric.tolerance;
+            const double change = expected > 0.0 ? (measured - expected) / expected : (measured > expected ? 1.0 : 0.0);
+
+            // Contadores exatos (tolerância 0): qualquer diferença, para cima ou para baixo, falha
+            const char* status = "ok";
+            if (tolerance == 0.0) {
+                if (std::fabs(measured - expected) > 1e-9 * std::max(1.0, std::fabs(expected))) {
+                    status = "DIFERENTE";
+                    ++regressions;
+                }
+            }
+            else if (measured > expected * (1.0 + tolerance) + 1e-9) {
+                status = "REGRESSAO";
+                ++regressions;
+            }
+            else if (measured < expected * (1.0 - tolerance) - 1e-9) {
+                status = "melhoria (atualizar a baseline)";
+            }
+            ++compared;
+
+            char changeText[32];
+            std::snprintf(changeText, sizeof(changeText), "%+.1f%%", change * 100.0);
+            std::cout << "   referencia " << std::setw(14) << formatValue(expected) << std::setw(9) << changeText
+                << "  (tolerancia " << tolerance * 100.0 << "%)  " << status << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "renderer: " << renderer << std::endl;
+    if (updateBaseline) {
+        if (!writeBaseline(baselinePath, renderer, repeats, baseline, medians)) {
+            std::cerr << "Falha ao gravar baseline em " << baselinePath << std::endl;
+            return -1;
+        }
+        std::cout << "Baseline atualizada: " << baselinePath << std::endl;
+        return 0;
+    }
+
+    std::cout << compared << " metricas comparadas, " << regressions << " regressoes" << std::endl;
+
+    // Sem nenhuma comparação o teste não verificou nada: não pode passar
+    if (compared == 0) {
+        std::cerr << "Nenhuma metrica comparada: a baseline nao tem valores (gravar com --update-baseline)" << std::endl;
+        return 1;
+    }
+    return regressions > 0 ? 1 : 0;
+}
\ No newline at end of file
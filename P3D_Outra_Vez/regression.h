@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string: caminhos do executável e da baseline
+ */
+#include <string>
+
+/**
+ * @brief Deteção de regressões de desempenho contra uma baseline guardada no repositório
+ *
+ * Executa um conjunto fixo de cenários deterministas, cada um como um
+ * processo filho do próprio executável em modo --bench:
+ * - cold_load: carregamento da cena sem a cache de programas
+ * - warm_load: carregamento com a cache de programas preenchida
+ * - render_1000: 1000 frames headless da cena original
+ * - stress_*: cenas geradas com várias mesas e centenas de bolas (malhas ou impostores)
+ *
+ * Cada cenário é repetido várias vezes e a mediana de cada métrica é
+ * comparada com o valor da baseline. Os tempos são "menor é melhor": há
+ * regressão quando a mediana ultrapassa o valor de referência mais a
+ * tolerância relativa dessa métrica. As métricas com tolerância 0 são
+ * contadores exatos e falham com qualquer diferença.
+ *
+ * Formato da baseline:
+ * {
+ *   "renderer": "...",
+ *   "repeats": 5,
+ *   "scenarios": {
+ *     "render_1000": {
+ *       "frame_ms.p50": { "value": 1.25, "tolerance": 0.10 }
+ *     }
+ *   }
+ * }
+ * Um valor null indica uma métrica ainda sem referência (é medida mas não falha);
+ * uma baseline sem nenhum valor numérico faz falhar a execução. Tanto os
+ * tempos como as contagens (draw_calls, triangles, memory.*, que mudam com
+ * o caminho de desenho escolhido pelo contexto) só valem para o renderer
+ * onde foram medidos: com outro renderer a execução falha logo no primeiro
+ * cenário, e a baseline tem de ser gravada de novo com --update-baseline.
+ */
+class RegressionHarness {
+public:
+    /**
+     * @brief Executa todos os cenários e compara-os com a baseline
+     * @param executable Caminho deste executável (argv[0]), usado para lançar os cenários
+     * @param baselinePath Ficheiro JSON com os valores de referência
+     * @param updateBaseline Regrava a baseline com as medianas medidas em vez de comparar
+     * @return 0 sem regressões, 1 se alguma métrica regrediu, nenhuma foi comparada ou a baseline é de outro renderer, -1 em caso de erro
+     */
+    static int run(const std::string& executable, const std::string& baselinePath, bool updateBaseline);
+};
\ No newline at end of file
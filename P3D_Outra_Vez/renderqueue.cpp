@@ -0,0 +1,419 @@
+/***********************************************************************
+ * Implementação da Fila de Renderização
+ *
+ * Os pacotes submetidos em cada frame são ordenados por uma chave de
+ * 64 bits (vista, pass, programa, material, profundidade) e desenhados
+ * por essa ordem, minimizando as trocas de estado do OpenGL.
+ ***********************************************************************/
+
+#include "renderqueue.h"
+#include "multidraw.h"
+#include "gpuprofiler.h"
+#include "clusteredlighting.h"
+#include "model.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+uint8_t RenderQueue::addView(const RenderView& view) {
+    // Uma vista a mais teria o mesmo índice que a vista 0 na chave
+    if (views.size() >= MAX_VIEWS) {
+        std::cerr << "RenderQueue: limite de " << static_cast<int>(MAX_VIEWS) << " vistas por frame, vista \"" << view.name << "\" ignorada" << std::endl;
+        return INVALID_VIEW;
+    }
+
+    // Plano far da projeção: perspetiva (P[2][3] = -1) ou ortográfica
+    const glm::mat4& p = view.projection;
+    const float far = (p[2][3] != 0.0f) ? p[3][2] / (p[2][2] + 1.0f) : (p[3][2] - 1.0f) / p[2][2];
+    const float range = (std::isfinite(far) && far > 0.0f) ? far : DEPTH_RANGE;
+
+    views.push_back(view);
+    viewDepthScale.push_back(1.0f / range);
+    return static_cast<uint8_t>(views.size() - 1);
+}
+
+/**
+ * @brief Atribui um índice compacto a um objeto OpenGL
+ *
+ * Os nomes de programas e texturas do OpenGL não cabem necessariamente
+ * nos bits reservados na chave, por isso cada nome recebe um índice
+ * sequencial quando é registado.
+ */
+void RenderQueue::registerSlot(std::vector<GLuint>& slots, GLuint name) {
+    if (std::find(slots.begin(), slots.end(), name) == slots.end()) {
+        slots.push_back(name);
+    }
+}
+
+/**
+ * @brief Devolve o índice compacto de um objeto OpenGL (o último, se não estiver registado)
+ */
+uint32_t RenderQueue::slotFor(const std::vector<GLuint>& slots, GLuint name, uint32_t maxSlots) {
+    auto it = std::find(slots.begin(), slots.end(), name);
+    if (it == slots.end()) {
+        return maxSlots - 1;
+    }
+    return static_cast<uint32_t>(it - slots.begin()) % maxSlots;
+}
+
+void RenderQueue::registerState(GLuint program, GLuint texture) {
+    registerSlot(programSlots, program);
+    registerSlot(textureSlots, texture);
+}
+
+uint64_t RenderQueue::makeSortKey(uint8_t viewId, RenderPass pass, GLuint program, GLuint texture, float viewDepth) const {
+    const uint64_t programSlot = slotFor(programSlots, program, 0x100);
+    const uint64_t textureSlot = slotFor(textureSlots, texture, 0x10000);
+
+    // Quantiza a profundidade em 32 bits até ao plano far da vista; perto da câmera = valor menor
+    float normalized = glm::clamp(viewDepth * viewDepthScale[viewId], 0.0f, 1.0f);
+    uint64_t depth = static_cast<uint32_t>(normalized * 4294967295.0);
+
+    // Pacotes transparentes são desenhados de trás para a frente
+    if (pass == PASS_TRANSPARENT) {
+        depth = ~depth & 0xFFFFFFFFull;
+    }
+
+    const uint64_t header = (static_cast<uint64_t>(viewId & 0xF) << 60) |
+        (static_cast<uint64_t>(pass & 0xF) << 56);
+
+    // Opacos com pre-pass: a profundidade já está resolvida, agrupa por estado
+    if (pass == PASS_OPAQUE && depthPrepass) {
+        return header | (programSlot << 48) | (textureSlot << 32) | depth;
+    }
+
+    // Restantes: a profundidade domina a ordem
+    return header | (depth << 24) | (programSlot << 16) | textureSlot;
+}
+
+void RenderQueue::record(RenderList& out, RenderPacket packet, uint8_t viewId, RenderPass pass, float viewDepth) const {
+    packet.key = makeSortKey(viewId, pass, packet.program, packet.texture, viewDepth);
+    out.push_back(packet);
+
+    if (pass == PASS_OPAQUE && depthPrepass) {
+        // Cópia só de profundidade (mantém o mesh: com multi-draw, é agrupada como a cor)
+        packet.program = packet.depthProgram ? packet.depthProgram : depthProgram;
+        packet.texture = 0;
+        packet.key = makeSortKey(viewId, PASS_DEPTH_PREPASS, packet.program, 0, viewDepth);
+        out.push_back(packet);
+    }
+}
+
+void RenderQueue::setDepthPrepass(bool enabled, GLuint depthOnlyProgram) {
+    depthPrepass = enabled && depthOnlyProgram != 0;
+    depthProgram = depthOnlyProgram;
+    registerState(depthProgram, 0);
+}
+
+/**
+ * @brief Configura o estado de profundidade/cor de um pass
+ */
+static void applyPassState(int pass, bool depthPrepass) {
+    if (pass == PASS_DEPTH_PREPASS) {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_LESS);
+    }
+    else if (pass == PASS_OPAQUE && depthPrepass) {
+        // Só passam os fragmentos que ficaram na frente durante o pre-pass
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+    }
+    else {
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_LESS);
+    }
+}
+
+/**
+ * @brief Nome do scope de GPU de um pass
+ */
+static const char* passName(int pass) {
+    static const char* const names[] = { "depth_prepass", "opaque", "transparent", "overlay" };
+    return pass >= 0 && pass < 4 ? names[pass] : "pass";
+}
+
+/**
+ * @brief Radix sort LSD sobre as chaves de 64 bits
+ *
+ * Ordena um vetor de índices em 8 passagens de 8 bits. Passagens em que
+ * todas as chaves têm o mesmo byte são saltadas, o que é o caso comum
+ * para os bits de vista/pass/programa quando a cena é pequena.
+ */
+void RenderQueue::sort() {
+    const size_t count = packets.size();
+    order.resize(count);
+    orderTmp.resize(count);
+    sortKeys.resize(count);
+    sortKeysTmp.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+        sortKeys[i] = packets[i].key;
+    }
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; ++i) {
+            ++histogram[(sortKeys[i] >> shift) & 0xFF];
+        }
+
+        // Todas as chaves partilham este byte: a passagem não altera a ordem
+        if (count == 0 || histogram[(sortKeys[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        // Converte o histograma em posições iniciais de cada balde
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            size_t n = bucket;
+            bucket = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t dst = histogram[(sortKeys[i] >> shift) & 0xFF]++;
+            sortKeysTmp[dst] = sortKeys[i];
+            orderTmp[dst] = order[i];
+        }
+
+        sortKeys.swap(sortKeysTmp);
+        order.swap(orderTmp);
+    }
+}
+
+const RenderQueue::ProgramUniforms& RenderQueue::uniformsFor(GLuint program) {
+    for (const ProgramUniforms& u : programUniforms) {
+        if (u.program == program) return u;
+    }
+
+    ProgramUniforms u;
+    u.program = program;
+    u.mvp = glGetUniformLocation(program, "MVP");
+    u.modelView = glGetUniformLocation(program, "ModelView");
+    u.ka = glGetUniformLocation(program, "ka");
+    u.kd = glGetUniformLocation(program, "kd");
+    u.ks = glGetUniformLocation(program, "ks");
+    u.ns = glGetUniformLocation(program, "ns");
+    programUniforms.push_back(u);
+    return programUniforms.back();
+}
+
+/**
+ * @brief Emite as chamadas de desenho pela ordem das chaves
+ *
+ * O estado atual (vista, programa, VAO, textura e uniforms por objeto)
+ * é memorizado para que só sejam feitas chamadas OpenGL quando algo
+ * muda de um pacote para o seguinte.
+ *
+ * Com multi-draw ativo, uma pré-passagem copia todos os pacotes
+ * agrupáveis (pela ordem final) para um único buffer de comandos do
+ * frame; durante o percurso, cada sequência contígua desses pacotes
+ * é emitida como uma só chamada (no pre-pass, com o programa de
+ * profundidade do MultiDrawBatch).
+ */
+void RenderQueue::execute() {
+    drawCalls = 0;
+    stateChanges = 0;
+    batchedDraws = 0;
+    triangles = 0;
+
+    // Limpa os alvos das vistas que o pedem (mesmo que não recebam pacotes)
+    for (const RenderView& view : views) {
+        if (view.clearMask) {
+            glBindFramebuffer(GL_FRAMEBUFFER, view.framebuffer);
+            glViewport(view.x, view.y, view.width, view.height);
+            glClear(view.clearMask);
+        }
+    }
+
+    // Pacotes agrupáveis: os do pre-pass só se houver programa de profundidade para o multi-draw
+    const bool batching = multiDraw && multiDraw->isReady();
+    const bool batchingDepth = batching && multiDraw->hasDepthProgram();
+    auto batchable = [&](const RenderPacket& packet) {
+        if (!batching || packet.mesh < 0) return false;
+        return batchingDepth || ((packet.key >> 56) & 0xF) != PASS_DEPTH_PREPASS;
+    };
+
+    if (batching) {
+        multiDraw->begin();
+        for (uint32_t index : order) {
+            const RenderPacket& packet = packets[index];
+            if (!batchable(packet)) continue;
+            // A MVP com a mesma expressão do desenho individual: a profundidade tem de coincidir com a do pre-pass
+            const RenderView& view = views[packet.key >> 60];
+            multiDraw->add(packet.mesh, (view.projection * view.view) * packet.model, view.view * packet.model);
+        }
+        multiDraw->upload();
+    }
+
+    int currentView = -1;
+    int currentPass = -1;
+    GLuint currentFramebuffer = 0;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLuint currentProgram = 0;
+    GLuint currentVAO = 0;
+    GLuint currentTexture = 0;
+    const ProgramUniforms* uniforms = nullptr;
+    glm::mat4 viewProjection(1.0f);
+    glm::mat4 viewMatrix(1.0f);
+    const Material* currentMaterial = nullptr;
+    bool materialSet = false;               // Os uniforms do material são do programa atual
+    static const Material defaultMaterial;  // Pacotes sem material
+
+    // Sequência pendente de desenhos agrupados
+    GLuint batchNext = 0;
+    GLuint runFirst = 0;
+    GLsizei runCount = 0;
+    bool runDepth = false;
+
+    auto flushRun = [&]() {
+        if (runCount == 0) return;
+        multiDraw->draw(runFirst, runCount, runDepth);
+        ++drawCalls;
+        runCount = 0;
+
+        // O multi-draw usa o seu próprio programa, VAO e textura
+        currentProgram = 0;
+        currentVAO = 0;
+        currentTexture = 0;
+    };
+
+    // Scopes de GPU abertos: vista > pass > grupo de pacotes
+    GpuProfiler* gpu = profiler && profiler->isMeasuring() ? profiler : nullptr;
+    bool viewScope = false;
+    bool passScope = false;
+    const char* currentLabel = nullptr;
+
+    // Fecha os scopes até ao nível indicado (0 = vista, 1 = pass, 2 = grupo)
+    auto closeScopes = [&](int level) {
+        if (!gpu) return;
+        if (currentLabel) { gpu->endScope(); currentLabel = nullptr; }
+        if (level <= 1 && passScope) { gpu->endScope(); passScope = false; }
+        if (level == 0 && viewScope) { gpu->endScope(); viewScope = false; }
+    };
+
+    for (uint32_t index : order) {
+        const RenderPacket& packet = packets[index];
+        const int viewId = static_cast<int>(packet.key >> 60);
+
+        if (viewId != currentView) {
+            flushRun();
+            closeScopes(0);
+            const RenderView& view = views[viewId];
+            if (view.framebuffer != currentFramebuffer) {
+                glBindFramebuffer(GL_FRAMEBUFFER, view.framebuffer);
+                currentFramebuffer = view.framebuffer;
+            }
+            glViewport(view.x, view.y, view.width, view.height);
+            viewProjection = view.projection * view.view;
+            viewMatrix = view.view;
+            if (lighting) lighting->bindView(static_cast<uint8_t>(viewId));
+            currentView = viewId;
+            currentPass = -1;
+            if (gpu) { gpu->beginScope(view.name); viewScope = true; }
+        }
+
+        const int pass = static_cast<int>((packet.key >> 56) & 0xF);
+        if (pass != currentPass) {
+            flushRun();
+            closeScopes(1);
+            applyPassState(pass, depthPrepass);
+            currentPass = pass;
+            if (gpu) { gpu->beginScope(passName(pass)); passScope = true; }
+        }
+
+        if (gpu && packet.label != currentLabel) {
+            flushRun();
+            closeScopes(2);
+            if (packet.label) { gpu->beginScope(packet.label); currentLabel = packet.label; }
+        }
+
+        if (packet.mode == GL_TRIANGLES) {
+            triangles += packet.count / 3;
+        }
+        else if (packet.mode == GL_TRIANGLE_STRIP && packet.count > 2) {
+            triangles += packet.count - 2;
+        }
+
+        if (batchable(packet)) {
+            if (runCount == 0) {
+                runFirst = batchNext;
+                runDepth = (pass == PASS_DEPTH_PREPASS);
+            }
+            ++runCount;
+            ++batchNext;
+            ++batchedDraws;
+            continue;
+        }
+        flushRun();
+
+        if (packet.program != currentProgram) {
+            glUseProgram(packet.program);
+            uniforms = &uniformsFor(packet.program);
+            currentProgram = packet.program;
+            materialSet = false;
+            ++stateChanges;
+        }
+
+        if (packet.vao != currentVAO) {
+            glBindVertexArray(packet.vao);
+            currentVAO = packet.vao;
+            ++stateChanges;
+        }
+
+        if (packet.texture && packet.texture != currentTexture) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, packet.texture);
+            currentTexture = packet.texture;
+            ++stateChanges;
+        }
+
+        const glm::mat4 mvp = viewProjection * packet.model;
+        glUniformMatrix4fv(uniforms->mvp, 1, GL_FALSE, glm::value_ptr(mvp));
+        if (uniforms->modelView >= 0) {
+            const glm::mat4 modelView = viewMatrix * packet.model;
+            glUniformMatrix4fv(uniforms->modelView, 1, GL_FALSE, glm::value_ptr(modelView));
+        }
+
+        // Coeficientes de Phong, só quando o material muda (os pacotes estão agrupados por textura)
+        if (uniforms->ka >= 0 && (!materialSet || packet.material != currentMaterial)) {
+            const Material& material = packet.material ? *packet.material : defaultMaterial;
+            glUniform3fv(uniforms->ka, 1, glm::value_ptr(material.ka));
+            glUniform3fv(uniforms->kd, 1, glm::value_ptr(material.kd));
+            glUniform3fv(uniforms->ks, 1, glm::value_ptr(material.ks));
+            glUniform1f(uniforms->ns, material.ns);
+            currentMaterial = packet.material;
+            materialSet = true;
+        }
+
+        if (packet.indexed) {
+            glDrawElements(packet.mode, packet.count, GL_UNSIGNED_INT, nullptr);
+        }
+        else {
+            glDrawArrays(packet.mode, 0, packet.count);
+        }
+        ++drawCalls;
+    }
+
+    flushRun();
+    closeScopes(0);
+
+    // Restaura o estado por omissão (necessário, p.ex., para glClear da profundidade)
+    applyPassState(PASS_OPAQUE, false);
+
+    // Restaura a janela como destino para o resto do frame
+    if (currentFramebuffer != 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
+
+void RenderQueue::clear() {
+    views.clear();
+    viewDepthScale.clear();
+    packets.clear();
+    order.clear();
+}
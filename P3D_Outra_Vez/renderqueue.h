@@ -0,0 +1,246 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: tipos inteiros de tamanho fixo para as chaves de ordenação
+ * - vector: armazenamento contíguo dos pacotes submetidos em cada frame
+ * - GL/glew: tipos e funções OpenGL
+ * - glm: matrizes de transformação de cada pacote
+ */
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class MultiDrawBatch;
+class GpuProfiler;
+class ClusteredLighting;
+struct Material;
+
+/**
+ * @brief Passes de renderização, na ordem em que são executados
+ *
+ * O pass ocupa bits altos da chave, logo todos os pacotes de um pass
+ * são desenhados antes de qualquer pacote do pass seguinte.
+ */
+enum RenderPass : uint8_t {
+    PASS_DEPTH_PREPASS = 0, // Só profundidade (gerado automaticamente para os opacos)
+    PASS_OPAQUE = 1,        // Geometria opaca (mesa, bolas)
+    PASS_TRANSPARENT = 2,   // Geometria com transparência (ordenada de trás para a frente)
+    PASS_OVERLAY = 3        // Elementos de interface desenhados por cima da cena
+};
+
+/**
+ * @brief Vista (viewport + câmera) para a qual os pacotes são submetidos
+ *
+ * Cada pacote referencia uma vista pelo seu índice; a fila troca de
+ * viewport e de matrizes apenas quando a vista muda entre pacotes.
+ */
+struct RenderView {
+    GLint x = 0, y = 0;              // Canto inferior esquerdo do viewport
+    GLsizei width = 0, height = 0;   // Dimensões do viewport
+    glm::mat4 view = glm::mat4(1.0f);       // Matriz de visualização
+    glm::mat4 projection = glm::mat4(1.0f); // Matriz de projeção
+    GLuint framebuffer = 0;          // Framebuffer de destino (0 = janela)
+    GLbitfield clearMask = 0;        // Buffers a limpar antes de desenhar a vista (0 = nenhum)
+    const char* name = "vista";      // Nome do scope de GPU da vista (literal)
+};
+
+/**
+ * @brief Pacote de desenho: tudo o que é preciso para emitir uma chamada de desenho
+ */
+struct RenderPacket {
+    uint64_t key = 0;                // Chave de ordenação (ver makeSortKey)
+    GLuint program = 0;              // Programa de shader
+    GLuint vao = 0;                  // Vertex Array Object com a geometria
+    GLuint texture = 0;              // Textura difusa (0 = cor por vértice)
+    GLenum mode = GL_TRIANGLES;      // Primitiva a desenhar
+    GLsizei count = 0;               // Número de vértices/índices
+    bool indexed = false;            // glDrawElements (true) ou glDrawArrays (false)
+    int mesh = -1;                   // Índice no MultiDrawBatch (-1 = desenho individual)
+    const char* label = nullptr;     // Grupo do scope de GPU ("mesa", "bolas"; literal, nullptr = nenhum)
+    GLuint depthProgram = 0;         // Programa do pre-pass para este pacote (0 = o da fila)
+    const Material* material = nullptr; // Coeficientes de Phong (nullptr = valores por omissão de Material)
+    glm::mat4 model = glm::mat4(1.0f); // Matriz de modelo
+};
+
+// Lista de pacotes construída fora da fila (p.ex. por uma thread de trabalho)
+typedef std::vector<RenderPacket> RenderList;
+
+/**
+ * @brief Fila de renderização ordenada por chave de 64 bits
+ *
+ * Os objetos da cena (mesa, bolas, ...) submetem pacotes para a fila em
+ * vez de desenharem diretamente. Uma vez por frame a fila é ordenada com
+ * radix sort e percorrida, alterando o estado do OpenGL (viewport,
+ * programa, VAO, textura) apenas quando este difere do pacote anterior.
+ *
+ * Layout da chave (do bit mais significativo para o menos significativo):
+ * - [63..60] vista (4 bits)
+ * - [59..56] pass (4 bits)
+ * - [55..0]  depende do pass:
+ *   - agrupado por estado:  programa (8) | material/textura (16) | profundidade (32)
+ *   - ordenado por profundidade: profundidade (32) | programa (8) | material/textura (16)
+ *
+ * Os opacos são ordenados da frente para trás, para que o early-Z
+ * rejeite os fragmentos escondidos. Com o pre-pass de profundidade ativo,
+ * cada pacote opaco gera também um pacote só de profundidade (ordenado
+ * da frente para trás, com o depthProgram do pacote ou, por omissão, o
+ * da fila) e o pass opaco passa a ser agrupado por estado, desenhando
+ * com GL_LEQUAL sobre a profundidade já preenchida: cada pixel visível
+ * é sombreado uma única vez. Os transparentes são
+ * ordenados de trás para a frente.
+ *
+ * Quando existe um MultiDrawBatch ativo, os pacotes com mesh >= 0 de uma
+ * mesma vista são agrupados e emitidos com uma única chamada
+ * glMultiDrawElementsIndirect; as suas cópias de profundidade também,
+ * com o programa de profundidade do MultiDrawBatch.
+ *
+ * Os programas iluminados recebem também a matriz Model-View e, quando
+ * o material muda, os coeficientes de Phong; com uma ClusteredLighting
+ * ativa, a grelha de luzes de cada vista é ligada ao mudar de vista.
+ *
+ * As listas de pacotes podem ser construídas em paralelo: registerState()
+ * regista antes os programas e texturas, e a partir daí record() apenas
+ * lê a fila, podendo ser chamado por várias threads, cada uma com a sua
+ * RenderList. A thread do OpenGL junta depois as listas com append().
+ */
+class RenderQueue {
+public:
+    static constexpr uint8_t MAX_VIEWS = 16;     // Vistas por frame (4 bits da chave)
+    static constexpr uint8_t INVALID_VIEW = 0xFF; // Devolvido por addView quando não há mais índices
+    static constexpr float DEPTH_RANGE = 100.0f; // Distância representada na chave quando a projeção não tem plano far finito
+
+    /**
+     * @brief Regista uma vista e devolve o seu índice (0..15)
+     *
+     * A profundidade das chaves da vista é quantizada até ao plano far da
+     * sua projeção.
+     *
+     * @return Índice da vista, ou INVALID_VIEW se já existirem MAX_VIEWS
+     *         vistas no frame (a vista é recusada)
+     */
+    uint8_t addView(const RenderView& view);
+
+    /**
+     * @brief Monta a chave de ordenação de um pacote
+     * @param viewId Índice da vista devolvido por addView
+     * @param pass Pass de renderização
+     * @param program Programa de shader do pacote
+     * @param texture Textura difusa do pacote (0 = nenhuma)
+     * @param viewDepth Distância do objeto à câmera, em unidades do mundo
+     */
+    uint64_t makeSortKey(uint8_t viewId, RenderPass pass, GLuint program, GLuint texture, float viewDepth) const;
+
+    /**
+     * @brief Reserva os índices compactos de um programa e de uma textura na chave
+     *
+     * Nomes não registados continuam a ser desenhados corretamente, mas
+     * partilham o último índice e por isso não ficam agrupados.
+     */
+    void registerState(GLuint program, GLuint texture);
+
+    /**
+     * @brief Calcula a chave e acrescenta o pacote a uma lista externa
+     *
+     * Pacotes opacos geram também o pacote do pre-pass, quando ativo.
+     * Não altera a fila: pode ser chamado em paralelo, desde que as vistas
+     * já tenham sido adicionadas e o estado registado; a lista é depois
+     * junta à fila com append().
+     *
+     * @param out Lista que recebe os pacotes
+     * @param packet Pacote a acrescentar (a chave é preenchida aqui)
+     * @param viewId Índice da vista
+     * @param pass Pass de renderização
+     * @param viewDepth Distância do objeto à câmera, em unidades do mundo
+     */
+    void record(RenderList& out, RenderPacket packet, uint8_t viewId, RenderPass pass, float viewDepth) const;
+
+    /**
+     * @brief Junta à fila uma lista construída com record()
+     */
+    void append(const RenderList& list) { packets.insert(packets.end(), list.begin(), list.end()); }
+
+    /**
+     * @brief Ativa ou desativa o pre-pass de profundidade
+     * @param enabled Estado do pre-pass
+     * @param depthOnlyProgram Programa que apenas transforma as posições
+     */
+    void setDepthPrepass(bool enabled, GLuint depthOnlyProgram);
+    bool isDepthPrepassEnabled() const { return depthPrepass; }
+
+    /**
+     * @brief Ordena os pacotes pela chave (radix sort LSD, 8 bits por passagem)
+     */
+    void sort();
+
+    /**
+     * @brief Percorre os pacotes ordenados e emite as chamadas de desenho
+     */
+    void execute();
+
+    /**
+     * @brief Descarta pacotes e vistas do frame anterior
+     *
+     * Mantém a capacidade dos vetores para evitar realocações por frame.
+     */
+    void clear();
+
+    /**
+     * @brief Ativa o agrupamento por multi-draw indireto (nullptr desativa)
+     */
+    void setMultiDraw(MultiDrawBatch* batch) { multiDraw = batch; }
+
+    /**
+     * @brief Mede o tempo de GPU de cada vista, pass e grupo de pacotes (nullptr desativa)
+     */
+    void setProfiler(GpuProfiler* gpuProfiler) { profiler = gpuProfiler; }
+
+    /**
+     * @brief Liga a grelha de luzes de cada vista quando a vista muda (nullptr desativa)
+     */
+    void setLighting(ClusteredLighting* clusteredLighting) { lighting = clusteredLighting; }
+
+    const RenderView& getView(uint8_t viewId) const { return views[viewId]; }
+    size_t size() const { return packets.size(); }
+
+    // Estatísticas do último execute()
+    unsigned int drawCalls = 0;     // Chamadas de desenho emitidas
+    unsigned int stateChanges = 0;  // Trocas de programa, VAO ou textura
+    unsigned int batchedDraws = 0;  // Pacotes emitidos através do multi-draw
+    unsigned long long triangles = 0; // Triângulos submetidos (individuais e agrupados)
+
+private:
+    /**
+     * @brief Localizações de uniforms de um programa, obtidas uma única vez
+     */
+    struct ProgramUniforms {
+        GLuint program = 0;
+        GLint mvp = -1;
+        GLint modelView = -1;        // Só nos programas iluminados
+        GLint ka = -1, kd = -1, ks = -1, ns = -1;
+    };
+
+    const ProgramUniforms& uniformsFor(GLuint program);
+    static void registerSlot(std::vector<GLuint>& slots, GLuint name);
+    static uint32_t slotFor(const std::vector<GLuint>& slots, GLuint name, uint32_t maxSlots);
+
+    std::vector<RenderView> views;         // Vistas registadas no frame atual
+    std::vector<float> viewDepthScale;     // 1 / plano far de cada vista (quantização da profundidade)
+    std::vector<RenderPacket> packets;     // Pacotes submetidos no frame atual
+    std::vector<uint32_t> order;           // Índices dos pacotes, na ordem final
+    std::vector<uint64_t> sortKeys;        // Buffers auxiliares do radix sort
+    std::vector<uint64_t> sortKeysTmp;
+    std::vector<uint32_t> orderTmp;
+
+    std::vector<GLuint> programSlots;      // Programa -> índice compacto na chave
+    std::vector<GLuint> textureSlots;      // Textura -> índice compacto na chave
+    std::vector<ProgramUniforms> programUniforms;
+
+    MultiDrawBatch* multiDraw = nullptr;   // Caminho de multi-draw (opcional)
+    GpuProfiler* profiler = nullptr;       // Scopes de GPU por vista/pass/grupo (opcional)
+    ClusteredLighting* lighting = nullptr; // Grelhas de luzes das vistas (opcional)
+
+    bool depthPrepass = false;             // Pre-pass de profundidade ativo
+    GLuint depthProgram = 0;               // Programa usado no pre-pass
+};
@@ -0,0 +1,76 @@
+/***********************************************************************
+ * Implementação dos Alvos de Renderização Fora do Ecrã
+ ***********************************************************************/
+
+#include "rendertarget.h"
+#include "gpumemory.h"
+#include <iostream>
+
+bool RenderTarget::create(GLsizei newWidth, GLsizei newHeight, bool withDepth) {
+    destroy();
+    width = newWidth;
+    height = newHeight;
+
+    // Textura de cor, sem mipmaps
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    GpuMemory::addTexture(GpuMemory::imageBytes(width, height, 1, 4));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+
+    // Profundidade num renderbuffer (só é usada pelo teste de profundidade)
+    if (withDepth) {
+        glGenRenderbuffers(1, &depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        GpuMemory::addTexture(GpuMemory::imageBytes(width, height, 1, 4));
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Framebuffer incompleto (0x" << std::hex << status << std::dec << ")" << std::endl;
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+void RenderTarget::destroy() {
+    if (fbo) glDeleteFramebuffers(1, &fbo);
+    if (colorTexture) {
+        glDeleteTextures(1, &colorTexture);
+        GpuMemory::addTexture(-GpuMemory::imageBytes(width, height, 1, 4));
+    }
+    if (depthBuffer) {
+        glDeleteRenderbuffers(1, &depthBuffer);
+        GpuMemory::addTexture(-GpuMemory::imageBytes(width, height, 1, 4));
+    }
+    fbo = colorTexture = depthBuffer = 0;
+}
+
+void RenderTarget::blitTo(GLuint dstFramebuffer, GLint x, GLint y, GLsizei dstWidth, GLsizei dstHeight,
+    GLenum filter) const {
+    blitRegionTo(width, height, dstFramebuffer, x, y, dstWidth, dstHeight, filter);
+}
+
+void RenderTarget::blitRegionTo(GLsizei srcWidth, GLsizei srcHeight, GLuint dstFramebuffer,
+    GLint x, GLint y, GLsizei dstWidth, GLsizei dstHeight, GLenum filter) const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dstFramebuffer);
+    glBlitFramebuffer(0, 0, srcWidth, srcHeight,
+        x, y, x + dstWidth, y + dstHeight,
+        GL_COLOR_BUFFER_BIT, filter);
+    glBindFramebuffer(GL_FRAMEBUFFER, dstFramebuffer);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - GL/glew: framebuffers, texturas e renderbuffers
+ */
+#include <GL/glew.h>
+
+/**
+ * @brief Alvo de renderização fora do ecrã (FBO com cor e profundidade)
+ *
+ * A cor fica numa textura (para poder ser lida ou copiada para a janela)
+ * e a profundidade num renderbuffer, que nunca é amostrado.
+ */
+class RenderTarget {
+public:
+    ~RenderTarget() { destroy(); }
+
+    /**
+     * @brief Cria (ou recria) o framebuffer com as dimensões indicadas
+     * @param width Largura em pixels
+     * @param height Altura em pixels
+     * @param withDepth Cria também um renderbuffer de profundidade
+     * @return true se o framebuffer ficou completo
+     */
+    bool create(GLsizei width, GLsizei height, bool withDepth = true);
+
+    /**
+     * @brief Liberta os objetos OpenGL do alvo
+     */
+    void destroy();
+
+    /**
+     * @brief Copia a cor do alvo para uma região de outro framebuffer
+     * @param dstFramebuffer Framebuffer de destino (0 = janela)
+     * @param x, y Canto inferior esquerdo da região de destino
+     * @param width, height Dimensões da região de destino
+     * @param filter GL_NEAREST ou GL_LINEAR (quando as dimensões diferem)
+     */
+    void blitTo(GLuint dstFramebuffer, GLint x, GLint y, GLsizei width, GLsizei height,
+        GLenum filter = GL_LINEAR) const;
+
+    /**
+     * @brief Copia apenas a região inferior esquerda do alvo (srcWidth x srcHeight)
+     *
+     * Usado quando só parte do alvo foi desenhada (resolução dinâmica).
+     */
+    void blitRegionTo(GLsizei srcWidth, GLsizei srcHeight, GLuint dstFramebuffer,
+        GLint x, GLint y, GLsizei width, GLsizei height, GLenum filter = GL_LINEAR) const;
+
+    GLuint getFramebuffer() const { return fbo; }
+    GLuint getColorTexture() const { return colorTexture; }
+    GLsizei getWidth() const { return width; }
+    GLsizei getHeight() const { return height; }
+    bool isValid() const { return fbo != 0; }
+
+private:
+    GLuint fbo = 0;             // Framebuffer Object
+    GLuint colorTexture = 0;    // Anexo de cor (GL_RGBA8)
+    GLuint depthBuffer = 0;     // Anexo de profundidade (GL_DEPTH_COMPONENT24)
+    GLsizei width = 0;
+    GLsizei height = 0;
+};
@@ -1,36 +1,157 @@
 #version 330 core
 
-// Variveis de entrada (do vertex shader)
+// Variantes: ver shader.vert (TEXTURED, VERTEX_COLOR, DEPTH_ONLY, IMPOSTOR, SPHERE_UV)
+
+#ifdef IMPOSTOR
+// A profundidade escrita nunca fica à frente do quad: o early-Z continua ativo, se suportado
+#extension GL_ARB_conservative_depth : enable
+#ifdef GL_ARB_conservative_depth
+layout(depth_greater) out float gl_FragDepth;
+#endif
+
+// Raio do fragmento (ver shader.vert)
+in vec4 rayNear;
+in vec4 rayFar;
+
+uniform mat4 MVP;
+uniform mat4 ModelView;
+
+// Recuo da profundidade na cor: o pre-pass e esta variante podem arredondar de forma diferente.
+// O quad fica ligeiramente à frente da esfera (shader.vert), por isso o recuo não o ultrapassa.
+const float DEPTH_BIAS = 1.0 / 4194304.0;
+
+/**
+ * Interseta o raio do fragmento com a esfera unitária do espaço do objeto
+ * O ponto devolvido é o mais próximo do raio com a esfera quando falha (para as derivadas continuarem definidas)
+ */
+bool intersectSphere(out vec3 hit) {
+    vec3 origin = rayNear.xyz / rayNear.w;
+    vec3 direction = rayFar.xyz / rayFar.w - origin;
+    float a = dot(direction, direction);
+    float b = dot(origin, direction);
+    float c = dot(origin, origin) - 1.0;
+    float discriminant = b * b - a * c;
+    float t = (-b - sqrt(max(discriminant, 0.0))) / a;
+    hit = origin + t * direction;
+    return discriminant >= 0.0;
+}
+
+/**
+ * Profundidade na janela do ponto de impacto
+ */
+float sphereDepth(vec3 hit) {
+    vec4 clip = MVP * vec4(hit, 1.0);
+    return 0.5 * (gl_DepthRange.diff * (clip.z / clip.w) + gl_DepthRange.near + gl_DepthRange.far);
+}
+#endif
+
+#ifdef DEPTH_ONLY
+
+// Pre-pass de profundidade: nenhuma cor é escrita, apenas o depth buffer
+void main() {
+#ifdef IMPOSTOR
+    vec3 hit;
+    if (!intersectSphere(hit)) discard;
+    gl_FragDepth = sphereDepth(hit);
+#endif
+}
+
+#else
+
+// Variáveis de entrada (do vertex shader)
+#ifndef IMPOSTOR
+in vec3 fragViewPosition;
+#endif
+#ifdef SPHERE_UV
+in vec3 fragPosition;
+#endif
+#if !defined(IMPOSTOR) && !defined(VERTEX_COLOR)
 in vec3 fragNormal;
+#endif
+#if defined(TEXTURED) && !defined(IMPOSTOR) && !defined(SPHERE_UV)
 in vec2 fragTexCoord;
+#endif
+#ifdef VERTEX_COLOR
 in vec3 fragColor;
+#endif
 
 // Uniforms
-uniform vec3 ambientLight;
-uniform int objectType;  // 0 para mesa, 1 para bola
-uniform bool hasTexture;
+#ifdef TEXTURED
 uniform sampler2D tex;
+#endif
+
+// Coeficientes de Phong do material (ver Material em model.h)
+uniform vec3 ka;
+uniform vec3 kd;
+uniform vec3 ks;
+uniform float ns;
+
+// Ambiente e luzes pontuais do cluster do fragmento (lighting.frag)
+vec3 shadeClustered(vec3 baseColor, vec3 position, vec3 normal, vec3 ka, vec3 kd, vec3 ks, float ns);
 
-// Sada
+// Saída
 out vec4 fragOutput;
 
+#if defined(TEXTURED) && (defined(IMPOSTOR) || defined(SPHERE_UV))
+// Coordenadas da textura das bolas numa direção e derivadas contínuas na costura (sphereuv.frag)
+vec2 sphereUV(vec3 normal, out vec2 gradX, out vec2 gradY);
+
+/**
+ * Lê a textura equirretangular na direção indicada (normal da esfera no espaço do objeto)
+ * Tem de ser chamada em controlo de fluxo uniforme (derivadas).
+ */
+vec3 textureSphere(vec3 normal) {
+    vec2 gradX, gradY;
+    vec2 uv = sphereUV(normal, gradX, gradY);
+    return textureGrad(tex, uv, gradX, gradY).rgb;
+}
+#endif
+
 void main() {
+#ifdef IMPOSTOR
+    // Normal e cor calculadas no ponto de impacto, antes do discard (as derivadas precisam dos vizinhos)
+    vec3 hit;
+    bool covered = intersectSphere(hit);
+    vec3 normal = normalize(hit);
+#ifdef TEXTURED
+    vec3 baseColor = textureSphere(normal);
+#endif
+    if (!covered) discard;
+    gl_FragDepth = max(sphereDepth(hit) - DEPTH_BIAS, gl_FragCoord.z);
+    vec3 position = vec3(ModelView * vec4(hit, 1.0));
+    normal = normalize(mat3(ModelView) * normal);
+#elif defined(SPHERE_UV)
+    // A posição interpolada fica ligeiramente dentro da esfera: normalizada, é a direção exata
+#ifdef TEXTURED
+    vec3 baseColor = textureSphere(normalize(fragPosition));
+#endif
+    vec3 position = fragViewPosition;
+    vec3 normal = normalize(fragNormal);
+#elif defined(VERTEX_COLOR)
+    // A mesa não tem normais por vértice: normal da face, a partir das derivadas da posição
+    vec3 position = fragViewPosition;
+    vec3 normal = normalize(cross(dFdx(fragViewPosition), dFdy(fragViewPosition)));
+#else
     // Normaliza a normal do fragmento
+    vec3 position = fragViewPosition;
     vec3 normal = normalize(fragNormal);
-    
-    // Define a cor base do objeto
-    vec3 baseColor;
-    if (hasTexture) {
-        baseColor = texture(tex, fragTexCoord).rgb;
-    } else {
-        baseColor = fragColor;
-    }
-    
-    // Aplica iluminao ambiente
-    vec3 ambient = ambientLight * baseColor;
-    
-    // Cor final  apenas a componente ambiente por enquanto
-    vec3 finalColor = ambient;
-    
+#endif
+
+    // Define a cor base do objeto (escolhida na compilação, sem ramos por fragmento)
+#if defined(TEXTURED) && (defined(IMPOSTOR) || defined(SPHERE_UV))
+    // Já lida acima
+#elif defined(TEXTURED)
+    vec3 baseColor = texture(tex, fragTexCoord).rgb;
+#elif defined(VERTEX_COLOR)
+    vec3 baseColor = fragColor;
+#else
+    vec3 baseColor = vec3(1.0);
+#endif
+
+    // Aplica a iluminação de Phong (ambiente e luzes pontuais do cluster)
+    vec3 finalColor = shadeClustered(baseColor, position, normal, ka, kd, ks, ns);
+
     fragOutput = vec4(finalColor, 1.0);
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
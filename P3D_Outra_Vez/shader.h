@@ -1,21 +1,45 @@
 #pragma once
-#include <GL\gl.h>
+#include <GL/gl.h>
 
 #define _DEBUG
 
 // Estrutura que representa um shader a ser carregado.
 // type: tipo do shader (ex: GL_VERTEX_SHADER, GL_FRAGMENT_SHADER)
 // filename: caminho para o ficheiro fonte do shader
-// shader: ID do shader criado aps compilao
+// shader: ID do shader criado após compilação
 typedef struct {
     GLenum       type;
     const char* filename;
     GLuint       shader;
 } ShaderInfo;
 
-// Funo que carrega, compila e linka um conjunto de shaders.
+// Função que carrega, compila e linka um conjunto de shaders.
 // Recebe um array de ShaderInfo e retorna o ID do programa OpenGL criado.
 GLuint LoadShaders(ShaderInfo*);
 
-// Funo que destri e libera os shaders criados (libera recursos da GPU).
+// Igual a LoadShaders, mas insere 'defines' (linhas "#define ...") logo a seguir
+// à diretiva #version de cada shader, para compilar variantes da mesma fonte.
+GLuint LoadShaders(ShaderInfo*, const char* defines);
+
+// Compilação assíncrona: LoadShadersAsync pede a compilação e o link e devolve
+// logo o programa; IsProgramReady indica (sem bloquear) se o driver já terminou;
+// FinishProgram verifica o link, mostra os logs em caso de erro e devolve o
+// programa pronto (ou 0). LoadShaders equivale a LoadShadersAsync + FinishProgram.
+GLuint LoadShadersAsync(ShaderInfo*, const char* defines);
+bool IsProgramReady(GLuint program);
+GLuint FinishProgram(GLuint program);
+
+// #defines comuns a todos os programas (p.ex. constantes partilhadas com o C++),
+// inseridos antes dos da variante. Chamar antes de pedir o primeiro programa.
+void SetShaderDefines(const char* defines);
+
+// Ativa KHR_parallel_shader_compile (khr = true) ou ARB_parallel_shader_compile
+void EnableParallelShaderCompile(bool khr);
+
+// Cache em disco usada por LoadShaders para reutilizar programas já linkados
+// (nullptr desativa). Ver programcache.h.
+class ProgramBinaryCache;
+void SetProgramBinaryCache(ProgramBinaryCache* cache);
+
+// Função que destrói e libera os shaders criados (libera recursos da GPU).
 void DestroyShaders(ShaderInfo*);
\ No newline at end of file
@@ -1,25 +1,110 @@
 #version 330 core
 
-// Atributos de entrada (vindos do VBO)
-layout(location = 0) in vec3 vPosition;  // Posio do vrtice
-layout(location = 1) in vec3 vNormal;    // Normal do vrtice
-layout(location = 2) in vec2 vTexCoord;  // Coordenada de textura
-in vec3 vColors;                         // Cor do vrtice
+// Variantes compiladas por ShaderVariants (um #define por funcionalidade):
+// - TEXTURED: bolas, cor lida da textura difusa
+// - VERTEX_COLOR: mesa, cor por vértice
+// - DEPTH_ONLY: pre-pass de profundidade, só a posição
+// - IMPOSTOR: esfera desenhada como um quad virado para a câmera (ver shader.frag)
+// - SPHERE_UV: malha esférica só com posições; normal e UV calculados por fragmento
+// As variantes com cor são iluminadas no espaço da vista (lighting.frag); as matrizes de modelo têm escala uniforme.
 
 // Uniforms
-uniform mat4 MVP;  // Matriz Model-View-Projection
+uniform mat4 MVP;        // Matriz Model-View-Projection
+uniform mat4 ModelView;  // Matriz Model-View (iluminação)
+
+// Mesma profundidade em todas as variantes e em shader_mdi.vert, para o teste GL_LEQUAL
+invariant gl_Position;
+
+#ifdef IMPOSTOR
+
+// Sem atributos: os 4 cantos do quad (GL_TRIANGLE_STRIP) vêm de gl_VertexID.
+// A esfera é a esfera unitária do espaço do objeto; o raio e a rotação vêm da matriz de modelo.
+
+// Extremos do raio de cada fragmento (planos near e far), no espaço do objeto e em coordenadas homogéneas.
+// São lineares na posição do vértice, por isso a interpolação com correção de perspetiva é exata.
+out vec4 rayNear;
+out vec4 rayFar;
+
+// Distância do plano do quad ao centro: um pouco além do raio, para a profundidade do quad ficar sempre à frente da esfera
+const float QUAD_OFFSET = 1.01;
+
+void main() {
+    mat4 inverseMVP = inverse(MVP);
 
-// Variveis de sada (para o fragment shader)
-out vec3 fragNormal;
+    // A câmera no espaço do objeto; numa projeção ortográfica w = 0 e obtém-se a direção para a câmera
+    vec4 eye = inverseMVP * vec4(0.0, 0.0, -1.0, 0.0);
+    vec3 toEye = eye.xyz;
+    float halfSize = 1.0;
+    if (abs(eye.w) > 1e-6) {
+        // Perspetiva: o quad, à frente da esfera do lado da câmera, tem de cobrir o cone da silhueta
+        toEye /= eye.w;
+        float distance = max(length(toEye), QUAD_OFFSET + 0.001);
+        halfSize = (distance - QUAD_OFFSET) / sqrt(distance * distance - 1.0);
+    }
+
+    vec3 axis = normalize(toEye);
+    vec3 side = normalize(cross(abs(axis.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0), axis));
+    vec3 up = cross(axis, side);
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+    vec3 position = axis * QUAD_OFFSET + (corner.x * side + corner.y * up) * halfSize;
+
+    gl_Position = MVP * vec4(position, 1.0);
+    rayNear = inverseMVP * vec4(gl_Position.xy, -gl_Position.w, gl_Position.w);
+    rayFar = inverseMVP * vec4(gl_Position.xy, gl_Position.w, gl_Position.w);
+}
+
+#else
+
+// Atributos de entrada (vindos do VBO)
+layout(location = 0) in vec3 vPosition;  // Posição do vértice
+#if !defined(DEPTH_ONLY) && !defined(SPHERE_UV) && !defined(VERTEX_COLOR)
+layout(location = 1) in vec3 vNormal;    // Normal do vértice (a mesa não tem: a normal da face é calculada no fragment shader)
+#endif
+#if defined(TEXTURED) && !defined(SPHERE_UV)
+layout(location = 2) in vec2 vTexCoord;  // Coordenada de textura
+#endif
+#ifdef VERTEX_COLOR
+layout(location = 3) in vec3 vColors;    // Cor do vértice
+#endif
+
+// Variáveis de saída (para o fragment shader)
+#ifndef DEPTH_ONLY
+out vec3 fragViewPosition;  // Posição no espaço da vista
+#endif
+#if defined(SPHERE_UV) && !defined(DEPTH_ONLY)
+out vec3 fragPosition;  // Posição no espaço do objeto (a normal de uma esfera centrada na origem)
+#endif
+#if !defined(DEPTH_ONLY) && !defined(VERTEX_COLOR)
+out vec3 fragNormal;    // Normal no espaço da vista (por normalizar)
+#endif
+#if defined(TEXTURED) && !defined(SPHERE_UV)
 out vec2 fragTexCoord;
+#endif
+#ifdef VERTEX_COLOR
 out vec3 fragColor;
+#endif
 
 void main() {
-    // Passa as variveis para o fragment shader
-    fragNormal = vNormal;
+    // Passa as variáveis para o fragment shader
+#ifndef DEPTH_ONLY
+    fragViewPosition = vec3(ModelView * vec4(vPosition, 1.0));
+#endif
+#if defined(SPHERE_UV) && !defined(DEPTH_ONLY)
+    // A normal da esfera é a direção da posição; é linear nela, por isso pode ser interpolada antes de normalizar
+    fragPosition = vPosition;
+    fragNormal = mat3(ModelView) * vPosition;
+#elif !defined(DEPTH_ONLY) && !defined(VERTEX_COLOR)
+    fragNormal = mat3(ModelView) * vNormal;
+#endif
+#if defined(TEXTURED) && !defined(SPHERE_UV)
     fragTexCoord = vTexCoord;
+#endif
+#ifdef VERTEX_COLOR
     fragColor = vColors;
+#endif
 
-    // Transforma a posio do vrtice
+    // Transforma a posição do vértice
     gl_Position = MVP * vec4(vPosition, 1.0);
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#version 430 core
+
+// Variáveis de entrada (do vertex shader)
+in vec3 fragViewPosition;
+in vec3 fragNormal;
+#ifdef SPHERE_UV
+in vec3 fragPosition;
+#else
+in vec2 fragTexCoord;
+#endif
+flat in uint fragLayer;
+
+// Uniforms
+uniform sampler2DArray texArray;  // Texturas de todas as bolas agrupadas
+
+// Coeficientes de Phong de cada modelo agrupado, indexados como as texturas (ver MultiDrawBatch)
+struct MaterialData {
+    vec4 ka;      // xyz
+    vec4 kd;      // xyz
+    vec4 ksNs;    // xyz: ks, w: ns
+};
+
+layout(std430, binding = 2) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// Ambiente e luzes pontuais do cluster do fragmento (lighting.frag)
+vec3 shadeClustered(vec3 baseColor, vec3 position, vec3 normal, vec3 ka, vec3 kd, vec3 ks, float ns);
+
+// Saída
+out vec4 fragOutput;
+
+#ifdef SPHERE_UV
+// Coordenadas da textura das bolas numa direção e derivadas contínuas na costura (sphereuv.frag)
+vec2 sphereUV(vec3 normal, out vec2 gradX, out vec2 gradY);
+#endif
+
+void main() {
+    // Cor base lida da camada do material deste desenho
+#ifdef SPHERE_UV
+    vec2 gradX, gradY;
+    vec2 uv = sphereUV(normalize(fragPosition), gradX, gradY);
+    vec3 baseColor = textureGrad(texArray, vec3(uv, float(fragLayer)), gradX, gradY).rgb;
+#else
+    vec3 baseColor = texture(texArray, vec3(fragTexCoord, float(fragLayer))).rgb;
+#endif
+
+    // Aplica a iluminação de Phong com o material deste desenho
+    MaterialData material = materials[fragLayer];
+    vec3 finalColor = shadeClustered(baseColor, fragViewPosition, normalize(fragNormal),
+        material.ka.xyz, material.kd.xyz, material.ksNs.xyz, material.ksNs.w);
+
+    fragOutput = vec4(finalColor, 1.0);
+}
\ No newline at end of file
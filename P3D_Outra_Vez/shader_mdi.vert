@@ -0,0 +1,64 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+// Com SPHERE_UV (definido por MultiDrawBatch) o VBO só tem posições: normal e UV são calculados por fragmento
+// Com DEPTH_ONLY (programa do pre-pass do MultiDrawBatch) só a posição é transformada
+
+// Atributos de entrada (vindos do VBO partilhado)
+layout(location = 0) in vec3 vPosition;  // Posição do vértice
+#if !defined(SPHERE_UV) && !defined(DEPTH_ONLY)
+layout(location = 1) in vec3 vNormal;    // Normal do vértice
+layout(location = 2) in vec2 vTexCoord;  // Coordenada de textura
+#endif
+
+// Dados por desenho (ver DrawData em multidraw.h)
+struct DrawData {
+    mat4 mvp;
+    mat4 modelView;
+    uint textureLayer;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+// Primeiro desenho da chamada atual (gl_DrawID recomeça em 0 em cada chamada)
+uniform uint drawBase;
+
+// Variáveis de saída (para o fragment shader)
+#ifndef DEPTH_ONLY
+out vec3 fragViewPosition;  // Posição no espaço da vista (iluminação)
+out vec3 fragNormal;        // Normal no espaço da vista (por normalizar)
+#ifdef SPHERE_UV
+out vec3 fragPosition;  // Posição no espaço do objeto (a normal de uma esfera centrada na origem)
+#else
+out vec2 fragTexCoord;
+#endif
+flat out uint fragLayer;
+#endif
+
+// Mesma profundidade que no pre-pass (shader.vert ou este shader com DEPTH_ONLY), para o teste GL_LEQUAL
+invariant gl_Position;
+
+void main() {
+    DrawData draw = draws[drawBase + uint(gl_DrawIDARB)];
+
+#ifndef DEPTH_ONLY
+    // Passa as variáveis para o fragment shader (escala uniforme: mat3 da Model-View serve para as normais)
+    fragViewPosition = vec3(draw.modelView * vec4(vPosition, 1.0));
+#ifdef SPHERE_UV
+    fragPosition = vPosition;
+    fragNormal = mat3(draw.modelView) * vPosition;
+#else
+    fragNormal = mat3(draw.modelView) * vNormal;
+    fragTexCoord = vTexCoord;
+#endif
+    fragLayer = draw.textureLayer;
+#endif
+
+    // Transforma a posição do vértice
+    gl_Position = draw.mvp * vec4(vPosition, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#version 430 core
+#extension GL_ARB_bindless_texture : require
+
+// Variáveis de entrada (do vertex shader)
+in vec3 fragViewPosition;
+in vec3 fragNormal;
+#ifdef SPHERE_UV
+in vec3 fragPosition;
+#else
+in vec2 fragTexCoord;
+#endif
+flat in uint fragLayer;  // Índice do material (derivado de gl_DrawID: uniforme em cada desenho)
+
+// Handles das texturas difusas, indexados pelo material (ver BindlessMaterials)
+layout(std430, binding = 1) readonly buffer MaterialHandles {
+    uvec2 handles[];
+};
+
+// Coeficientes de Phong de cada modelo agrupado, indexados como as texturas (ver MultiDrawBatch)
+struct MaterialData {
+    vec4 ka;      // xyz
+    vec4 kd;      // xyz
+    vec4 ksNs;    // xyz: ks, w: ns
+};
+
+layout(std430, binding = 2) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// Ambiente e luzes pontuais do cluster do fragmento (lighting.frag)
+vec3 shadeClustered(vec3 baseColor, vec3 position, vec3 normal, vec3 ka, vec3 kd, vec3 ks, float ns);
+
+// Saída
+out vec4 fragOutput;
+
+#ifdef SPHERE_UV
+// Coordenadas da textura das bolas numa direção e derivadas contínuas na costura (sphereuv.frag)
+vec2 sphereUV(vec3 normal, out vec2 gradX, out vec2 gradY);
+#endif
+
+void main() {
+    // Cor base lida diretamente do handle do material, sem texturas ligadas
+    sampler2D diffuse = sampler2D(handles[fragLayer]);
+#ifdef SPHERE_UV
+    vec2 gradX, gradY;
+    vec2 uv = sphereUV(normalize(fragPosition), gradX, gradY);
+    vec3 baseColor = textureGrad(diffuse, uv, gradX, gradY).rgb;
+#else
+    vec3 baseColor = texture(diffuse, fragTexCoord).rgb;
+#endif
+
+    // Aplica a iluminação de Phong com o material deste desenho
+    MaterialData material = materials[fragLayer];
+    vec3 finalColor = shadeClustered(baseColor, fragViewPosition, normalize(fragNormal),
+        material.ka.xyz, material.kd.xyz, material.ksNs.xyz, material.ksNs.w);
+
+    fragOutput = vec4(finalColor, 1.0);
+}
\ No newline at end of file
@@ -2,25 +2,56 @@
 
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
 
 #define GLEW_STATIC
-#include <GL\glew.h>
+#include <GL/glew.h>
 
 #include "shader.h"
+#include "programcache.h"
 
-// Funo auxiliar para ler o contedo de um ficheiro de shader para uma string
+// Cache de binários ativa (opcional)
+static ProgramBinaryCache* programCache = nullptr;
+
+void SetProgramBinaryCache(ProgramBinaryCache* cache) {
+	programCache = cache;
+}
+
+// #defines inseridos em todas as fontes, antes dos de cada variante
+static std::string commonDefines;
+
+void SetShaderDefines(const char* defines) {
+	commonDefines = defines ? defines : "";
+}
+
+// Programa pedido com LoadShadersAsync cujo resultado ainda não foi verificado
+struct PendingProgram {
+	uint64_t cacheKey = 0;                 // 0 = não guardar na cache
+	std::vector<GLuint> shaders;           // Shaders anexados (apagados em FinishProgram)
+	std::vector<std::string> filenames;    // Para identificar os logs de erro
+};
+static std::unordered_map<GLuint, PendingProgram> pendingPrograms;
+
+// Compilação paralela ativa: IsProgramReady consulta GL_COMPLETION_STATUS
+static bool parallelCompile = false;
+
+// Função auxiliar para ler o conteúdo de um ficheiro de shader para uma string
 static const GLchar* ReadShader(const char* filename) {
-	// Abre o ficheiro em modo binrio e posiciona no final para obter o tamanho
+	// Abre o ficheiro em modo binário e posiciona no final para obter o tamanho
 	std::ifstream ficheiro(filename, std::ifstream::ate | std::ifstream::binary);
 	if (ficheiro.is_open()) {
-		// Obtm o tamanho do ficheiro
+		// Obtém o tamanho do ficheiro
 		std::streampos tamanhoDoFicheiroEmBytes = ficheiro.tellg();
-		// Volta ao incio do ficheiro
+		// Volta ao início do ficheiro
 		ficheiro.seekg(0, std::ios::beg);
 
-		// Aloca memria para o contedo do ficheiro (+1 para o terminador nulo)
+		// Aloca memória para o conteúdo do ficheiro (+1 para o terminador nulo)
 		GLchar* source = new GLchar[int(tamanhoDoFicheiroEmBytes) + 1];
-		// L o ficheiro para o array 'source'
+		// Lê o ficheiro para o array 'source'
 		ficheiro.read(source, tamanhoDoFicheiroEmBytes);
 		source[tamanhoDoFicheiroEmBytes] = 0; // Fecha a string
 
@@ -33,83 +64,184 @@ static const GLchar* ReadShader(const char* filename) {
 	return nullptr;
 }
 
-// Funo que carrega, compila e linka um conjunto de shaders, retornando o ID do programa OpenGL
+// Função auxiliar que insere os #defines de uma variante a seguir à linha #version
+// (o GLSL exige que #version seja a primeira diretiva). Liberta 'source'.
+static const GLchar* InjectDefines(const GLchar* source, const char* defines) {
+	if (source == nullptr || defines == nullptr || defines[0] == 0) return source;
+
+	// Ponto de inserção: início da linha seguinte à de #version (ou início do ficheiro)
+	size_t insertAt = 0;
+	const char* version = std::strstr(source, "#version");
+	if (version != nullptr) {
+		const char* endOfLine = std::strchr(version, '\n');
+		insertAt = endOfLine ? (endOfLine - source) + 1 : std::strlen(source);
+	}
+
+	// #line repõe a numeração original, para que os erros de compilação apontem a linha certa
+	int nextLine = 1;
+	for (size_t i = 0; i < insertAt; ++i) {
+		if (source[i] == '\n') ++nextLine;
+	}
+	char lineDirective[32];
+	std::snprintf(lineDirective, sizeof(lineDirective), "\n#line %d\n", nextLine);
+
+	const size_t sourceLength = std::strlen(source);
+	const size_t definesLength = std::strlen(defines);
+	const size_t lineLength = std::strlen(lineDirective);
+	GLchar* result = new GLchar[sourceLength + definesLength + lineLength + 2];
+	std::memcpy(result, source, insertAt);
+	size_t length = insertAt;
+	if (insertAt > 0 && source[insertAt - 1] != '\n') result[length++] = '\n';
+	std::memcpy(result + length, defines, definesLength);
+	length += definesLength;
+	std::memcpy(result + length, lineDirective, lineLength);
+	length += lineLength;
+	std::memcpy(result + length, source + insertAt, sourceLength - insertAt);
+	length += sourceLength - insertAt;
+	result[length] = 0;
+
+	delete[] source;
+	return result;
+}
+
+// Função que carrega, compila e linka um conjunto de shaders, retornando o ID do programa OpenGL
 GLuint LoadShaders(ShaderInfo* shaders) {
+	return LoadShaders(shaders, nullptr);
+}
+
+// Como LoadShaders, compilando cada fonte com os #defines indicados
+GLuint LoadShaders(ShaderInfo* shaders, const char* defines) {
+	GLuint program = LoadShadersAsync(shaders, defines);
+	return program != 0 ? FinishProgram(program) : 0;
+}
+
+// Ativa a compilação em paralelo pelo driver (KHR/ARB_parallel_shader_compile)
+void EnableParallelShaderCompile(bool khr) {
+	// 0xFFFFFFFF: o driver escolhe o número de threads
+	if (khr) glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	else glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+	parallelCompile = true;
+}
+
+// Pede a compilação e o link sem esperar pelo resultado (ver FinishProgram)
+GLuint LoadShadersAsync(ShaderInfo* shaders, const char* defines) {
 	if (shaders == nullptr) return 0;
 
+	// Lê todas as fontes (já com os #defines) antes de criar objetos OpenGL
+	const std::string allDefines = commonDefines + (defines ? defines : "");
+	std::vector<GLenum> types;
+	std::vector<std::string> sources;
+	for (GLint i = 0; shaders[i].type != GL_NONE; i++) {
+		shaders[i].shader = 0;
+		const GLchar* source = InjectDefines(ReadShader(shaders[i].filename), allDefines.c_str());
+		if (source == NULL) return 0;
+		types.push_back(shaders[i].type);
+		sources.push_back(source);
+		delete[] source;
+	}
+
+	// Programa já linkado numa execução anterior: evita compilar
+	PendingProgram pending;
+	if (programCache != nullptr && programCache->isEnabled()) {
+		pending.cacheKey = programCache->makeKey(types, sources);
+		GLuint cached = programCache->load(pending.cacheKey);
+		if (cached != 0) return cached;
+	}
+
 	// Cria um novo programa OpenGL
 	GLuint program = glCreateProgram();
+	if (pending.cacheKey != 0) {
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 
-	// Para cada shader na lista
+	// Para cada shader na lista: compila e anexa, sem consultar o estado
+	// (qualquer glGetShaderiv obrigaria o driver a terminar a compilação aqui)
 	for (GLint i = 0; shaders[i].type != GL_NONE; i++) {
 		// Cria o objeto shader do tipo especificado (vertex, fragment, etc.)
 		shaders[i].shader = glCreateShader(shaders[i].type);
 
-		// L o cdigo fonte do shader
-		const GLchar* source = ReadShader(shaders[i].filename);
-		if (source == NULL) {
-			// Em caso de erro, apaga todos os shaders j criados
-			for (int j = 0; shaders[j].type != GL_NONE; j++) {
-				if (shaders[j].shader != 0)
-					glDeleteShader(shaders[j].shader);
-				shaders[j].shader = 0;
-			}
-			return 0;
-		}
-
-		// Associa o cdigo fonte ao shader e compila
+		// Associa o código fonte ao shader e compila
+		const GLchar* source = sources[i].c_str();
 		glShaderSource(shaders[i].shader, 1, &source, NULL);
-		delete[] source;
 		glCompileShader(shaders[i].shader);
 
-		// Verifica se compilou corretamente
-		GLint compiled;
-		glGetShaderiv(shaders[i].shader, GL_COMPILE_STATUS, &compiled);
-		if (!compiled) {
-#ifdef _DEBUG
-			GLsizei len;
-			glGetShaderiv(shaders[i].shader, GL_INFO_LOG_LENGTH, &len);
-			GLchar* log = new GLchar[len + 1];
-			glGetShaderInfoLog(shaders[i].shader, len, &len, log);
-			std::cerr << "Shader compilation failed: " << log << std::endl;
-			delete[] log;
-#endif
-			// Em caso de erro, apaga todos os shaders j criados
-			for (int j = 0; shaders[j].type != GL_NONE; j++) {
-				if (shaders[j].shader != 0)
-					glDeleteShader(shaders[j].shader);
-				shaders[j].shader = 0;
-			}
-			return 0;
-		}
-
-		// Anexa o shader compilado ao programa
+		// Anexa o shader ao programa
 		glAttachShader(program, shaders[i].shader);
+		pending.shaders.push_back(shaders[i].shader);
+		pending.filenames.push_back(shaders[i].filename);
 	}
 
-	// Tenta linkar o programa
+	// Pede o link (com compilação paralela, regressa de imediato)
 	glLinkProgram(program);
 
-	// Verifica se o link foi bem-sucedido
+	pendingPrograms[program] = pending;
+	return program;
+}
+
+// Indica se o driver já terminou de compilar e linkar o programa
+bool IsProgramReady(GLuint program) {
+	if (!parallelCompile || pendingPrograms.find(program) == pendingPrograms.end()) return true;
+
+	GLint completed = GL_FALSE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+	return completed == GL_TRUE;
+}
+
+// Conclui um programa pedido com LoadShadersAsync: verifica o link e só então lê os logs
+GLuint FinishProgram(GLuint program) {
+	auto it = pendingPrograms.find(program);
+	if (it == pendingPrograms.end()) return program; // Carregado da cache ou já concluído
+
+	PendingProgram pending = it->second;
+	pendingPrograms.erase(it);
+
+	// Verifica se o link foi bem-sucedido (espera pelo driver, se ainda não terminou)
 	GLint linked;
 	glGetProgramiv(program, GL_LINK_STATUS, &linked);
 	if (!linked) {
 #ifdef _DEBUG
-		GLsizei len;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
-		GLchar* log = new GLchar[len + 1];
-		glGetProgramInfoLog(program, len, &len, log);
-		std::cerr << "Shader linking failed: " << log << std::endl;
-		delete[] log;
+		// Um shader que não compilou explica o link falhado; senão mostra o log do link
+		bool compileFailed = false;
+		for (size_t i = 0; i < pending.shaders.size(); i++) {
+			GLint compiled;
+			glGetShaderiv(pending.shaders[i], GL_COMPILE_STATUS, &compiled);
+			if (compiled) continue;
+
+			GLsizei len;
+			glGetShaderiv(pending.shaders[i], GL_INFO_LOG_LENGTH, &len);
+			GLchar* log = new GLchar[len + 1];
+			glGetShaderInfoLog(pending.shaders[i], len, &len, log);
+			std::cerr << "Shader compilation failed (" << pending.filenames[i] << "): " << log << std::endl;
+			delete[] log;
+			compileFailed = true;
+		}
+		if (!compileFailed) {
+			GLsizei len;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
+			GLchar* log = new GLchar[len + 1];
+			glGetProgramInfoLog(program, len, &len, log);
+			std::cerr << "Shader linking failed: " << log << std::endl;
+			delete[] log;
+		}
 #endif
-		// Em caso de erro, apaga todos os shaders j criados
-		for (int j = 0; shaders[j].type != GL_NONE; j++) {
-			if (shaders[j].shader != 0)
-				glDeleteShader(shaders[j].shader);
-			shaders[j].shader = 0;
+		// Em caso de erro, apaga os shaders e o programa
+		for (GLuint shader : pending.shaders) {
+			glDeleteShader(shader);
 		}
+		glDeleteProgram(program);
 		return 0;
 	}
 
+	// Os objetos shader já não são necessários depois do link
+	for (GLuint shader : pending.shaders) {
+		glDetachShader(program, shader);
+		glDeleteShader(shader);
+	}
+
+	// Guarda o binário para os próximos arranques
+	if (pending.cacheKey != 0) {
+		programCache->store(pending.cacheKey, program);
+	}
+
 	return program; // Retorna o ID do programa OpenGL pronto para uso
 }
\ No newline at end of file
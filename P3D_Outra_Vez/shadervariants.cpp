@@ -0,0 +1,96 @@
+/***********************************************************************
+ * Implementação das Variantes de Shader
+ ***********************************************************************/
+
+#include "shadervariants.h"
+#include "shader.h"
+#include <iostream>
+
+void ShaderVariants::setSources(const std::string& vertex, const std::string& fragment, const std::string& lighting,
+    const std::string& sphereUV) {
+    vertexPath = vertex;
+    fragmentPath = fragment;
+    lightingPath = lighting;
+    sphereUVPath = sphereUV;
+}
+
+std::string ShaderVariants::makeDefines(unsigned int features) {
+    std::string defines;
+    if (features & SHADER_TEXTURED) defines += "#define TEXTURED\n";
+    if (features & SHADER_VERTEX_COLOR) defines += "#define VERTEX_COLOR\n";
+    if (features & SHADER_DEPTH_ONLY) defines += "#define DEPTH_ONLY\n";
+    if (features & SHADER_IMPOSTOR) defines += "#define IMPOSTOR\n";
+    if (features & SHADER_SPHERE_UV) defines += "#define SPHERE_UV\n";
+    return defines;
+}
+
+void ShaderVariants::reportFailure(unsigned int features) const {
+    std::cerr << "Falha ao compilar a variante 0x" << std::hex << features << std::dec
+        << " de " << vertexPath << "/" << fragmentPath << std::endl;
+}
+
+void ShaderVariants::request(unsigned int features) {
+    if (programs.find(features) != programs.end()) return;
+
+    // O pre-pass não precisa das funções de iluminação: a lista termina antes delas
+    // (o UV das esferas só é lido pelas variantes texturadas e iluminadas, por isso vem depois)
+    const bool lit = !lightingPath.empty() && !(features & SHADER_DEPTH_ONLY);
+    const bool sphereUV = lit && !sphereUVPath.empty() && (features & SHADER_TEXTURED) &&
+        (features & (SHADER_IMPOSTOR | SHADER_SPHERE_UV));
+    ShaderInfo shaders[] = {
+        { GL_VERTEX_SHADER,   vertexPath.c_str() },
+        { GL_FRAGMENT_SHADER, fragmentPath.c_str() },
+        { lit ? GLenum(GL_FRAGMENT_SHADER) : GLenum(GL_NONE), lightingPath.c_str() },
+        { sphereUV ? GLenum(GL_FRAGMENT_SHADER) : GLenum(GL_NONE), sphereUVPath.c_str() },
+        { GL_NONE, NULL }
+    };
+
+    Variant variant;
+    variant.program = LoadShadersAsync(shaders, makeDefines(features).c_str());
+    variant.finished = variant.program == 0;  // Fonte em falta: nada a concluir
+    if (!variant.program) reportFailure(features);
+    programs[features] = variant;
+}
+
+size_t ShaderVariants::finishReady() {
+    size_t pending = 0;
+    for (auto& entry : programs) {
+        Variant& variant = entry.second;
+        if (variant.finished) continue;
+        if (!IsProgramReady(variant.program)) {
+            pending++;
+            continue;
+        }
+        variant.program = FinishProgram(variant.program);
+        variant.finished = true;
+        if (!variant.program) reportFailure(entry.first);
+    }
+    return pending;
+}
+
+GLuint ShaderVariants::get(unsigned int features) {
+    request(features);
+
+    // Também as falhas ficam em cache, para não recompilar em cada pedido
+    Variant& variant = programs[features];
+    if (!variant.finished) {
+        variant.program = FinishProgram(variant.program);
+        variant.finished = true;
+        if (!variant.program) reportFailure(features);
+    }
+    return variant.program;
+}
+
+GLuint ShaderVariants::find(unsigned int features) const {
+    auto it = programs.find(features);
+    return it != programs.end() && it->second.finished ? it->second.program : 0;
+}
+
+void ShaderVariants::destroy() {
+    for (auto& entry : programs) {
+        Variant& variant = entry.second;
+        if (!variant.finished) variant.program = FinishProgram(variant.program);
+        if (variant.program) glDeleteProgram(variant.program);
+    }
+    programs.clear();
+}
\ No newline at end of file
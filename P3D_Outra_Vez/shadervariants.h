@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string: caminhos das fontes e texto dos #defines
+ * - unordered_map: cache de programas por máscara de funcionalidades
+ * - GL/glew: programas de shader
+ */
+#include <string>
+#include <unordered_map>
+#include <GL/glew.h>
+
+/**
+ * @brief Funcionalidades de uma variante (bits da máscara)
+ *
+ * Cada bit corresponde a um #define com o mesmo nome, sem o prefixo
+ * SHADER_, inserido nas fontes antes da compilação.
+ */
+enum ShaderFeature : unsigned int {
+    SHADER_TEXTURED = 1u << 0,      // Cor lida da textura difusa (bolas)
+    SHADER_VERTEX_COLOR = 1u << 1,  // Cor por vértice (mesa)
+    SHADER_DEPTH_ONLY = 1u << 2,    // Só posição, sem cor (pre-pass de profundidade)
+    SHADER_IMPOSTOR = 1u << 3,      // Esfera calculada por raio sobre um quad (bolas, ver SphereImpostor)
+    SHADER_SPHERE_UV = 1u << 4      // Vértices só com posição; normal e UV calculados (ObjModel::hasSphereVertices)
+};
+
+/**
+ * @brief Programas especializados compilados a partir de um único par de fontes
+ *
+ * Em vez de um programa genérico que decide por fragmento (uniform bool)
+ * o que fazer, cada combinação de funcionalidades é compilada à parte,
+ * com os #defines correspondentes, e guardada numa cache indexada pela
+ * máscara. Os pacotes são encaminhados para a variante adequada.
+ *
+ * request() apenas pede a compilação (em paralelo pelo driver, quando
+ * KHR_parallel_shader_compile existe), para que possa decorrer enquanto
+ * outros recursos são carregados; finishReady() conclui, sem bloquear, as
+ * que o driver já terminou e get() conclui o programa, compilando-o
+ * primeiro se nunca tiver sido pedido. Só podem ser chamados na thread
+ * do OpenGL; find() apenas consulta a cache.
+ */
+class ShaderVariants {
+public:
+    ~ShaderVariants() { destroy(); }
+
+    /**
+     * @brief Define as fontes partilhadas por todas as variantes
+     * @param lightingPath Fragment shader adicional ligado às variantes com cor (vazio = nenhum)
+     * @param sphereUVPath Fragment shader adicional ligado às variantes texturadas com IMPOSTOR ou SPHERE_UV (vazio = nenhum)
+     */
+    void setSources(const std::string& vertexPath, const std::string& fragmentPath, const std::string& lightingPath = "",
+        const std::string& sphereUVPath = "");
+
+    /**
+     * @brief Pede a compilação de uma variante sem esperar pelo resultado
+     */
+    void request(unsigned int features);
+
+    /**
+     * @brief Conclui as variantes pedidas cujo link o driver já terminou, sem esperar pelas restantes
+     * @return Número de variantes ainda em compilação
+     */
+    size_t finishReady();
+
+    /**
+     * @brief Devolve o programa de uma combinação de funcionalidades, compilando-o se necessário
+     * @param features Máscara de ShaderFeature
+     * @return ID do programa, ou 0 se a compilação falhou
+     */
+    GLuint get(unsigned int features);
+
+    /**
+     * @brief Devolve um programa já concluído por get() (0 se ainda não existir)
+     */
+    GLuint find(unsigned int features) const;
+
+    /**
+     * @brief Monta o bloco de #defines de uma máscara
+     */
+    static std::string makeDefines(unsigned int features);
+
+    /**
+     * @brief Apaga todos os programas da cache
+     */
+    void destroy();
+
+    size_t size() const { return programs.size(); }
+
+private:
+    void reportFailure(unsigned int features) const;
+
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::string lightingPath;   // Funções de iluminação (não usadas por DEPTH_ONLY)
+    std::string sphereUVPath;   // Mapeamento da textura das esferas (só nas variantes que o leem)
+    /**
+     * @brief Programa de uma variante e o estado da sua compilação
+     */
+    struct Variant {
+        GLuint program = 0;     // 0 = falhou
+        bool finished = false;  // Link já verificado (FinishProgram)
+    };
+
+    std::unordered_map<unsigned int, Variant> programs;  // Máscara -> variante
+};
\ No newline at end of file
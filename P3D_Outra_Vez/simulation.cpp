@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Implementação da Simulação
+ *
+ * Passos de duração fixa numa thread própria; cada passo termina com a
+ * publicação de um snapshot da cena no buffer triplo.
+ ***********************************************************************/
+
+#include "simulation.h"
+#include "cpuprofiler.h"
+#include <chrono>
+
+void Simulation::init(const Camera& initialCamera, bool ambientOn, const std::vector<BallState>& initialBalls,
+    const CameraLimits& cameraLimits) {
+    camera = initialCamera;
+    limits = cameraLimits;
+    ambientLightOn = ambientOn;
+    time = 0.0;
+    tickCount = 0;
+
+    balls = initialBalls;
+
+    publish();
+}
+
+void Simulation::start(double tickHz) {
+    stop();
+    running = true;
+    thread = std::thread(&Simulation::threadLoop, this, tickHz);
+}
+
+void Simulation::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void Simulation::pushInput(const InputEvent& event) {
+    std::lock_guard<std::mutex> lock(inputMutex);
+    pendingInput.push_back(event);
+}
+
+void Simulation::threadLoop(double tickHz) {
+    using clock = std::chrono::steady_clock;
+    const double dt = 1.0 / tickHz;
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(dt));
+
+    PROFILE_THREAD("simulacao");
+
+    auto next = clock::now();
+    while (running) {
+        step(dt);
+
+        // Passo fixo: se a simulação se atrasar, não tenta recuperar mais de um passo
+        next += period;
+        const auto now = clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Simulation::step(double dt) {
+    PROFILE_ZONE("Simulation::step");
+
+    // Recolhe a entrada acumulada desde o último passo
+    {
+        std::lock_guard<std::mutex> lock(inputMutex);
+        processingInput.swap(pendingInput);
+    }
+    for (const InputEvent& event : processingInput) {
+        applyInput(event);
+    }
+    processingInput.clear();
+
+    time += dt;
+    ++tickCount;
+    publish();
+}
+
+void Simulation::applyInput(const InputEvent& event) {
+    switch (event.type) {
+    case InputEvent::ORBIT:
+        camera.rotateAroundTarget(event.value);
+        break;
+    case InputEvent::HEIGHT:
+        camera.height = glm::clamp(camera.height + event.value, limits.minHeight, limits.maxHeight);
+        camera.updatePosition();
+        break;
+    case InputEvent::ZOOM:
+        camera.fov = glm::clamp(camera.fov - event.value, limits.minFov, limits.maxFov);
+        break;
+    case InputEvent::TOGGLE_AMBIENT:
+        ambientLightOn = !ambientLightOn;
+        break;
+    }
+}
+
+void Simulation::publish() {
+    // O buffer devolvido contém um snapshot antigo: é reescrito por inteiro
+    SceneSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.tick = tickCount.load(std::memory_order_relaxed);
+    snapshot.time = time;
+    snapshot.camera = camera;
+    snapshot.ambientLightOn = ambientLightOn;
+    snapshot.balls = balls;
+    snapshots.publish();
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - vector: estados das bolas e fila de eventos de entrada
+ * - thread, mutex, atomic: execução da simulação numa thread própria
+ * - glm: posições e orientações
+ * - camera: estado da câmera simulado
+ * - triplebuffer: publicação dos snapshots para a thread de renderização
+ */
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "camera.h"
+#include "triplebuffer.h"
+
+/**
+ * @brief Estado de uma bola visto pela renderização
+ */
+struct BallState {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+};
+
+/**
+ * @brief Cena completa num instante da simulação
+ *
+ * Depois de publicado, um snapshot não é alterado até voltar ao
+ * produtor, por isso a renderização pode lê-lo sem sincronização.
+ */
+struct SceneSnapshot {
+    unsigned long long tick = 0;       // Número do passo da simulação
+    double time = 0.0;                 // Tempo simulado, em segundos
+    Camera camera;                     // Câmera principal
+    bool ambientLightOn = true;        // Estado da luz ambiente
+    std::vector<BallState> balls;      // Uma entrada por bola, pela ordem de criação
+};
+
+/**
+ * @brief Evento de entrada entregue pela thread da janela à simulação
+ */
+struct InputEvent {
+    enum Type {
+        ORBIT,          // Rodar a câmera à volta do alvo (radianos)
+        HEIGHT,         // Variação da altura da câmera
+        ZOOM,           // Variação do campo de visão (scroll)
+        TOGGLE_AMBIENT  // Liga/desliga a luz ambiente
+    };
+
+    Type type;
+    float value;
+};
+
+/**
+ * @brief Limites aplicados à câmera pela simulação
+ */
+struct CameraLimits {
+    float minFov = 15.0f;
+    float maxFov = 90.0f;
+    float minHeight = 0.5f;
+    float maxHeight = 30.0f;
+};
+
+/**
+ * @brief Simulação do jogo (entrada, câmera e estado das bolas)
+ *
+ * Corre numa thread própria a uma frequência fixa e, no fim de cada
+ * passo, publica um snapshot imutável da cena num buffer triplo. A
+ * thread do OpenGL desenha sempre o snapshot completo mais recente:
+ * um frame lento não atrasa a simulação e uma simulação lenta não
+ * impede a renderização de continuar.
+ *
+ * Os callbacks do GLFW só podem correr na thread da janela, por isso
+ * apenas convertem os eventos e entregam-nos com pushInput().
+ *
+ * Também pode ser avançada de forma síncrona com step() (modo headless),
+ * o que torna os resultados determinísticos.
+ */
+class Simulation {
+public:
+    ~Simulation() { stop(); }
+
+    /**
+     * @brief Define o estado inicial e publica o primeiro snapshot
+     */
+    void init(const Camera& camera, bool ambientLightOn, const std::vector<BallState>& balls,
+        const CameraLimits& limits);
+
+    /**
+     * @brief Inicia a thread da simulação
+     * @param tickHz Passos por segundo
+     */
+    void start(double tickHz);
+
+    /**
+     * @brief Para a thread da simulação
+     */
+    void stop();
+
+    /**
+     * @brief Entrega um evento de entrada (pode ser chamado de qualquer thread)
+     */
+    void pushInput(const InputEvent& event);
+
+    /**
+     * @brief Avança a simulação um passo e publica o snapshot
+     * @param dt Duração do passo, em segundos
+     */
+    void step(double dt);
+
+    /**
+     * @brief Passa a ler o snapshot publicado mais recente (thread de renderização)
+     * @return true se há um snapshot novo
+     */
+    bool acquireLatest() { return snapshots.update(); }
+
+    /**
+     * @brief Snapshot obtido pelo último acquireLatest()
+     */
+    const SceneSnapshot& latest() const { return snapshots.readBuffer(); }
+
+    unsigned long long getTickCount() const { return tickCount.load(std::memory_order_relaxed); }
+
+private:
+    void threadLoop(double tickHz);
+    void applyInput(const InputEvent& event);
+    void publish();
+
+    // Estado da simulação (só a thread da simulação lhe acede)
+    Camera camera;
+    CameraLimits limits;
+    bool ambientLightOn = true;
+    std::vector<BallState> balls;
+    double time = 0.0;
+    std::atomic<unsigned long long> tickCount{ 0 };
+
+    // Entrada: a thread da janela acrescenta, a simulação consome
+    std::mutex inputMutex;
+    std::vector<InputEvent> pendingInput;
+    std::vector<InputEvent> processingInput;
+
+    TripleBuffer<SceneSnapshot> snapshots;
+
+    std::thread thread;
+    std::atomic<bool> running{ false };
+};
\ No newline at end of file
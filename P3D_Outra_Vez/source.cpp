@@ -6,56 +6,101 @@
  * It includes camera controls, lighting, and 3D model rendering.
  ***********************************************************************/
 
- // Vinculao de bibliotecas necessrias
+ // Vinculação de bibliotecas necessárias
 #pragma comment(lib, "glew32s.lib")
 #pragma comment(lib, "glfw3.lib")
 #pragma comment(lib, "opengl32.lib")
 
-// Incluses padro
+// Inclusões padrão
 #include <iostream>
 #include <vector>
-
-// Configurao do GLEW para linkagem esttica
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <cstdio>
+
+// Configuração do GLEW para linkagem estática
 #define GLEW_STATIC
-#include <GL\glew.h>
-#include <gl\GL.h>
-#include <GLFW\glfw3.h>
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <GLFW/glfw3.h>
 
-// GLM para operaes matemticas 3D
+// GLM para operações matemáticas 3D
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// Cabealhos do projeto
+// Cabeçalhos do projeto
 #include "shader.h"
 #include "camera.h"
 #include "model.h"
+#include "renderqueue.h"
+#include "glcaps.h"
+#include "multidraw.h"
+#include "frustum.h"
+#include "minimap.h"
+#include "transform.h"
+#include "pipelinestats.h"
+#include "dynres.h"
+#include "headless.h"
+#include "capture.h"
+#include "simulation.h"
+#include "taskpool.h"
+#include "framepacer.h"
+#include "streambuffer.h"
+#include "shadervariants.h"
+#include "programcache.h"
+#include "gpuprofiler.h"
+#include "cpuprofiler.h"
+#include "gpumemory.h"
+#include "perfoverlay.h"
+#include "stressscene.h"
+#include "benchreport.h"
+#include "regression.h"
+#include "impostor.h"
+#include "clusteredlighting.h"
 
 /**
- * Constantes de configurao da janela e visualizao
+ * Constantes de configuração da janela e visualização
  */
 constexpr int WIDTH = 640;           // Largura da janela principal
 constexpr int HEIGHT = 480;          // Altura da janela principal
 constexpr int MINIMAP_SIZE = 150;    // Tamanho do minimapa
-constexpr int MINIMAP_PADDING = 10;  // Espaamento do minimapa
+constexpr int MINIMAP_PADDING = 10;  // Espaçamento do minimapa
+constexpr double MINIMAP_MAX_REFRESH_HZ = 10.0; // Frequência máxima de atualização do minimapa
+constexpr double FRAME_BUDGET_MS = 16.6;        // Tempo por frame pretendido (resolução dinâmica)
+constexpr float MIN_RESOLUTION_SCALE = 0.5f;    // Escala mínima da vista principal
+constexpr double SIMULATION_HZ = 120.0;         // Passos por segundo da thread de simulação
+constexpr double HEADLESS_STEP = 1.0 / 60.0;    // Passo da simulação por frame no modo headless
+constexpr GLsizeiptr STREAM_REGION_SIZE = 1 << 20; // Bytes por frame do buffer circular persistente
+constexpr const char* PROGRAM_CACHE_DIR = "shadercache"; // Binários dos programas linkados
 
 /**
- * Configuraes do OpenGL
+ * Dimensões da mesa (metade da largura, altura e profundidade)
  */
-#define NumBuffers 3                 // Nmero de buffers OpenGL (vrtices, cores, ndices)
-const GLuint NumVertices = 8;        // Nmero de vrtices da mesa
-const GLuint NumIndices = 6 * 2 * 3; // Nmero de ndices para tringulos
+constexpr GLfloat tableWidth = 9.0f;
+constexpr GLfloat tableHeight = 0.5f;
+constexpr GLfloat tableDepth = 5.5f;
 
 /**
- * Limites da cmera
+ * Configurações do OpenGL
  */
-constexpr float MIN_FOV = 15.0f;     // Campo de viso mnimo
-constexpr float MAX_FOV = 90.0f;     // Campo de viso mximo
-constexpr float MIN_HEIGHT = 0.5f;   // Altura mnima da cmera
-constexpr float MAX_HEIGHT = 30.0f;  // Altura mxima da cmera
+#define NumBuffers 3                 // Número de buffers OpenGL (vértices, cores, índices)
+const GLuint NumVertices = 8;        // Número de vértices da mesa
+const GLuint NumIndices = 6 * 2 * 3; // Número de índices para triângulos
 
 /**
- * Estrutura para controle de iluminao
+ * Limites da câmera
+ */
+constexpr float MIN_FOV = 15.0f;     // Campo de visão mínimo
+constexpr float MAX_FOV = 90.0f;     // Campo de visão máximo
+constexpr float MIN_HEIGHT = 0.5f;   // Altura mínima da câmera
+constexpr float MAX_HEIGHT = 30.0f;  // Altura máxima da câmera
+
+/**
+ * Estrutura para controle de iluminação
  * Gerencia propriedades da luz ambiente
  */
 struct LightingParams {
@@ -70,60 +115,141 @@ struct LightingParams {
     }
 };
 
-/**
- * Estrutura para luz pontual
- * Define posio e propriedades de uma fonte de luz
- */
- /*struct PointLight {
-     glm::vec3 position;  // Posio da luz no espao 3D
-     glm::vec3 color;     // Cor da luz
-     float intensity;     // Intensidade da luz
-
-     PointLight() :
-         position(5.0f, 5.0f, 0.0f),
-         color(1.0f),
-         intensity(1.0f) {
-     }
- };*/
-
  /**
-  * Variveis globais do estado do jogo
+  * Variáveis globais do estado do jogo
   */
-LightingParams lighting;        // Controle de iluminao
-//PointLight mainLight;                // Luz principal
-GLuint program;                 // Programa de shader
+LightingParams lighting;        // Controle de iluminação
+std::vector<PointLight> pointLights;   // Candeeiros das mesas e luzes de destaque (--lights)
+bool pointLightsOn = true;             // Luzes pontuais ligadas (tecla 7)
+ClusteredLighting clusteredLighting;   // Listas de luzes por cluster de cada vista
+Material tableMaterial;                // Phong da mesa (cores por vértice, quase mate)
+ProgramBinaryCache programCache; // Binários dos programas guardados entre execuções
+ShaderVariants shaderVariants;  // Variantes de shader.vert/shader.frag, por máscara de funcionalidades
+GLuint texturedProgram;         // Variante TEXTURED (bolas)
+GLuint sphereProgram;           // Variante TEXTURED | SPHERE_UV (bolas com vértices só de posição)
+GLuint vertexColorProgram;      // Variante VERTEX_COLOR (mesa)
 GLuint VAO;                     // Vertex Array Object
 GLuint Buffers[NumBuffers];     // Buffer Objects
-Camera camera;                  // Cmera principal
-Camera topDownCamera;           // Cmera do minimapa
+Camera camera;                  // Câmera principal
+Camera topDownCamera;           // Câmera do minimapa
+RenderQueue renderQueue;        // Fila de renderização ordenada por chave
+GLCapabilities glCaps;          // Capacidades do contexto OpenGL criado
+MultiDrawBatch multiDraw;       // Submissão das bolas por multi-draw indireto (GL 4.3+)
+
+BoundingSpheres ballBounds;           // Esferas envolventes das bolas (SoA), atualizadas por frame
+CullStats viewCullStats[RenderQueue::MAX_VIEWS]; // Contadores de culling por vista
+MinimapCache minimap;                 // Minimapa guardado numa textura entre frames
+GLuint depthProgram;                  // Variante DEPTH_ONLY, usada no pre-pass de profundidade
+SphereImpostor ballImpostor;          // Bolas desenhadas como quads calculados por raio (variantes IMPOSTOR)
+bool ballImpostors = false;           // Impostores em vez das malhas das bolas (--impostors, tecla 6)
+PipelineStatsQuery pipelineStats;     // Invocações de vértices/fragmentos por frame (se suportado)
+DynamicResolution dynamicResolution;  // Alvo da vista principal com escala ajustada ao tempo do frame
+FrameCapture frameCapture;            // Gravação dos frames (--capture)
+Simulation simulation;                // Entrada, câmera e bolas; publica snapshots para a renderização
+
+/**
+ * Tarefa de construção da lista de desenho: um intervalo de bolas de uma vista
+ */
+struct BuildTask {
+    uint8_t viewId = 0;
+    Frustum frustum;
+    uint32_t begin = 0;              // Intervalo de bolas [begin, end)
+    uint32_t end = 0;
+    bool includeTable = false;       // As mesas são tratadas pela primeira tarefa de cada vista
+    RenderList packets;              // Saída: pacotes prontos a juntar à fila
+    std::vector<uint32_t> visible;   // Auxiliar: bolas visíveis do intervalo
+    CullStats stats;
+};
+
+constexpr uint32_t BUILD_RANGE = 256;  // Bolas por tarefa (múltiplo de 8, o lote do culling SIMD)
+TaskPool taskPool;                     // Threads de trabalho da construção das listas
+std::vector<BuildTask> buildTasks;     // Tarefas do frame (reutilizadas entre frames)
+std::vector<uint8_t> frameViews;       // Vistas registadas no frame atual
+double renderListBuildMs = 0.0;        // Tempo da construção das listas no último frame
+FramePacer framePacer;                 // Ritmo dos frames e estatísticas de apresentação
+StreamBuffer streamBuffer;             // Dados dinâmicos por frame (comandos e DrawData do multi-draw)
+GpuProfiler gpuProfiler;               // Tempos de GPU por vista, pass e grupo de objetos
+PerfOverlay perfOverlay;               // Painel de desempenho (tecla 5)
+
+// Localizações de uniforms (obtidas uma vez em init)
+GLint texturedAmbientLightLoc = -1;
+GLint vertexColorAmbientLightLoc = -1;
+GLint mdiAmbientLightLoc = -1;
+GLint impostorAmbientLightLoc = -1;
+GLint sphereAmbientLightLoc = -1;
+
+const glm::vec3 tablePosition(0.0f, -2.0f, 0.0f); // Posição da mesa original no mundo
+SceneConfig sceneConfig;                          // Dimensão da cena (--tables, --balls, --share)
+std::vector<glm::vec3> tablePositions;            // Centro de cada mesa da cena
 
 std::vector<ObjModel*> bolas;   // Bolas de Bilhar
+TransformStore transforms;      // Transformações de todos os modelos (SoA)
+
+/**
+ * Variante de shader de uma bola: textura difusa, ou cor por vértice se não tiver textura
+ * (numa esfera só com posições, a variante que calcula a normal e o UV)
+ */
+GLuint ballProgram(const ObjModel* bola) {
+    if (!bola->getDiffuseTexture()) return vertexColorProgram;
+    return bola->hasSphereVertices() ? sphereProgram : texturedProgram;
+}
 
 /**
- * Estrutura para controle de entrada do usurio
+ * Estrutura para controle de entrada do usuário
  */
 struct InputState {
-    bool isPressing = false;         // Indica se boto do mouse est pressionado
-    double prevXpos = 0.0;          // Posio X anterior do mouse
-    double prevYpos = 0.0;          // Posio Y anterior do mouse
-    double xPos = 0.0;              // Posio X atual do mouse
-    double yPos = 0.0;              // Posio Y atual do mouse
+    bool isPressing = false;         // Indica se botão do mouse está pressionado
+    double prevXpos = 0.0;          // Posição X anterior do mouse
+    double prevYpos = 0.0;          // Posição Y anterior do mouse
+    double xPos = 0.0;              // Posição X atual do mouse
+    double yPos = 0.0;              // Posição Y atual do mouse
 } input;
 
-// Declaraes antecipadas de funes
+// Declarações antecipadas de funções
 void print_error(int error, const char* description);
+GLFWwindow* createWindow(void);
 void init(void);
-void display(const glm::mat4& view, const glm::mat4& projection);
+void display(const std::vector<uint8_t>& viewIds);
 
 /**
  * Callback de teclado
- * Processa eventos de teclado para controle de iluminao
+ * Processa eventos de teclado para controle de iluminação
  */
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (action == GLFW_PRESS || action == GLFW_REPEAT) {
         switch (key) {
-        case GLFW_KEY_1: // Tecla 1 liga/desliga luz ambiente
-            lighting.isAmbientLightOn = !lighting.isAmbientLightOn;
+        case GLFW_KEY_1: // Tecla 1 liga/desliga luz ambiente (estado do jogo: passa pela simulação)
+            simulation.pushInput({ InputEvent::TOGGLE_AMBIENT, 0.0f });
+            break;
+        case GLFW_KEY_2: // Tecla 2 liga/desliga o pre-pass de profundidade
+            renderQueue.setDepthPrepass(!renderQueue.isDepthPrepassEnabled(), depthProgram);
+            std::cout << "Pre-pass de profundidade: " << (renderQueue.isDepthPrepassEnabled() ? "ligado" : "desligado");
+            if (pipelineStats.hasResults()) {
+                std::cout << " (fragmentos no ultimo frame medido: " << pipelineStats.getFragmentInvocations() << ")";
+            }
+            std::cout << std::endl;
+            break;
+        case GLFW_KEY_3: // Tecla 3 liga/desliga a resolução dinâmica
+            dynamicResolution.setEnabled(!dynamicResolution.isEnabled());
+            std::cout << "Resolucao dinamica: " << (dynamicResolution.isEnabled() ? "ligada" : "desligada") << std::endl;
+            break;
+        case GLFW_KEY_4: // Tecla 4 mostra os tempos de GPU medidos
+            gpuProfiler.report(std::cout);
+            break;
+        case GLFW_KEY_5: // Tecla 5 mostra/esconde o painel de desempenho
+            perfOverlay.setEnabled(!perfOverlay.isEnabled());
+            break;
+        case GLFW_KEY_6: // Tecla 6 alterna entre as malhas das bolas e os impostores
+            if (ballImpostor.isReady()) {
+                ballImpostors = !ballImpostors;
+                minimap.invalidate();
+                std::cout << "Bolas: " << (ballImpostors ? "impostores" : "malhas") << std::endl;
+            }
+            break;
+        case GLFW_KEY_7: // Tecla 7 liga/desliga as luzes pontuais
+            pointLightsOn = !pointLightsOn;
+            minimap.invalidate();
+            std::cout << "Luzes pontuais: " << (pointLightsOn ? "ligadas" : "desligadas") << std::endl;
             break;
         }
     }
@@ -131,40 +257,35 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 
 /**
  * Callback de scroll do mouse
- * Controla o zoom da cmera atravs do campo de viso (FOV)
+ * Controla o zoom da câmera através do campo de visão (FOV)
  */
 void scrollCallBack(GLFWwindow* window, double xoffset, double yoffset) {
-    camera.fov = glm::clamp(camera.fov - static_cast<float>(yoffset), MIN_FOV, MAX_FOV);
+    simulation.pushInput({ InputEvent::ZOOM, static_cast<float>(yoffset) });
 }
 
 /**
  * Callback de movimento do mouse
- * Controla a rotao e altura da cmera
+ * Controla a rotação e altura da câmera
  */
 void cursorCallBack(GLFWwindow* window, double xpos, double ypos) {
     input.xPos = xpos;
     input.yPos = ypos;
 
     if (input.isPressing) {
-        // Rotao horizontal da cmera
+        // Rotação horizontal da câmera
         const double deltaX = xpos - input.prevXpos;
-        camera.rotateAroundTarget(static_cast<float>(deltaX) / -WIDTH * glm::pi<float>());
+        simulation.pushInput({ InputEvent::ORBIT, static_cast<float>(deltaX) / -WIDTH * glm::pi<float>() });
         input.prevXpos = xpos;
 
-        // Ajuste de altura da cmera
+        // Ajuste de altura da câmera
         const double deltaY = ypos - input.prevYpos;
-        camera.height = glm::clamp(
-            camera.height + static_cast<float>(-deltaY) / HEIGHT,
-            MIN_HEIGHT,
-            MAX_HEIGHT
-        );
-        camera.updatePosition();
+        simulation.pushInput({ InputEvent::HEIGHT, static_cast<float>(-deltaY) / HEIGHT });
     }
 }
 
 /**
- * Callback de boto do mouse
- * Gerencia o estado de presso do mouse para controle da cmera
+ * Callback de botão do mouse
+ * Gerencia o estado de pressão do mouse para controle da câmera
  */
 void mouseCallBack(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
@@ -177,13 +298,526 @@ void mouseCallBack(GLFWwindow* window, int button, int action, int mods) {
 }
 
 /**
- * Funo principal
- * Ponto de entrada da aplicao, configura o ambiente OpenGL e executa o loop principal
+ * Opções da linha de comandos
+ */
+struct CommandLine {
+    bool headless = false;       // --headless: sem janela, N frames e estatísticas no stdout
+    int frames = 300;            // --frames N: frames desenhados no modo headless
+    std::string dumpPath;        // --dump ficheiro.ppm: grava o último frame
+    std::string capturePath;     // --capture ficheiro(.raw|.png): grava todos os frames
+    PacingMode pacing = PACING_VSYNC; // --pacing vsync|adaptive|uncapped|fixed
+    double targetFps = 60.0;     // --fps N: limite do modo fixo
+    std::string gpuProfilePath;  // --gpu-profile ficheiro.txt: tempos de GPU por scope no fim
+    std::string tracePath;       // --trace ficheiro.json: zonas de CPU no formato Chrome Trace Event
+    std::string benchPath;       // --bench relatorio.json: headless com órbita fixa da câmera e relatório JSON
+    SceneConfig scene;           // --tables N --balls M --share none|textures|meshes --lights N
+    bool impostors = false;      // --impostors: bolas desenhadas como impostores em vez de malhas
+    bool programCache = true;    // --no-program-cache: compila sempre os programas (carregamento a frio)
+    std::string regressionPath;  // --regression baseline.json: corre os cenários e compara com a baseline
+    bool updateBaseline = false; // --update-baseline: com --regression, regrava a baseline com as medianas
+};
+
+/**
+ * Interpreta os argumentos do programa
+ * @return false se algum argumento for inválido
+ */
+bool parseCommandLine(int argc, char** argv, CommandLine& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--headless") {
+            options.headless = true;
+        }
+        else if (arg == "--frames" && i + 1 < argc) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--dump" && i + 1 < argc) {
+            options.dumpPath = argv[++i];
+        }
+        else if (arg == "--capture" && i + 1 < argc) {
+            options.capturePath = argv[++i];
+        }
+        else if (arg == "--pacing" && i + 1 < argc && FramePacer::parseMode(argv[i + 1], options.pacing)) {
+            ++i;
+        }
+        else if (arg == "--fps" && i + 1 < argc) {
+            options.targetFps = std::atof(argv[++i]);
+        }
+        else if (arg == "--gpu-profile" && i + 1 < argc) {
+            options.gpuProfilePath = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        }
+        else if (arg == "--bench" && i + 1 < argc) {
+            options.benchPath = argv[++i];
+            options.headless = true;
+        }
+        else if (arg == "--tables" && i + 1 < argc) {
+            options.scene.tables = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--balls" && i + 1 < argc) {
+            options.scene.ballsPerTable = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--share" && i + 1 < argc && StressScene::parseSharing(argv[i + 1], options.scene.sharing)) {
+            ++i;
+        }
+        else if (arg == "--lights" && i + 1 < argc) {
+            options.scene.accentLights = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--impostors") {
+            options.impostors = true;
+        }
+        else if (arg == "--no-program-cache") {
+            options.programCache = false;
+        }
+        else if (arg == "--regression" && i + 1 < argc) {
+            options.regressionPath = argv[++i];
+        }
+        else if (arg == "--update-baseline") {
+            options.updateBaseline = true;
+        }
+        else {
+            std::cerr << "Argumento desconhecido: " << arg << std::endl;
+            std::cerr << "Uso: " << argv[0] << " [--headless [--frames N] [--dump imagem.ppm]] [--capture video.raw|frames.png]"
+                << " [--pacing vsync|adaptive|uncapped|fixed] [--fps N] [--gpu-profile tempos.txt] [--trace trace.json]"
+                << " [--bench relatorio.json] [--tables N] [--balls M] [--share none|textures|meshes] [--lights N]"
+                << " [--impostors] [--no-program-cache]"
+                << " [--regression baseline.json [--update-baseline]]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Tempo monotónico em segundos (independente do GLFW, que não existe no modo headless)
+ */
+double nowSeconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Inicializa o GLEW e identifica as capacidades do contexto atual
+ * @param useProgramCache Reutiliza os programas linkados guardados em disco
+ */
+bool initGL(bool useProgramCache) {
+    glewExperimental = GL_TRUE; // Habilita recursos modernos do OpenGL
+    GLenum glewStatus = glewInit();
+#if defined(P3D_HEADLESS_EGL) && !defined(GLEW_EGL)
+    // GLEW compilado para GLX (o das distribuições Linux): sem ecrã X só falha a parte
+    // GLX, as funções do contexto EGL já foram carregadas
+    if (glewStatus == GLEW_ERROR_NO_GLX_DISPLAY) glewStatus = GLEW_OK;
+#endif
+    if (glewStatus != GLEW_OK) {
+        std::cerr << "Falha ao inicializar GLEW" << std::endl;
+        return false;
+    }
+
+    // Identifica as funcionalidades opcionais do contexto
+    glCaps = probeGLCapabilities();
+    printGLCapabilities(glCaps);
+
+    // Programas linkados em execuções anteriores são reutilizados a partir do disco
+    if (useProgramCache && programCache.init(PROGRAM_CACHE_DIR, glCaps)) {
+        SetProgramBinaryCache(&programCache);
+    }
+
+    // O driver compila os shaders noutras threads; LoadShadersAsync não bloqueia
+    if (glCaps.parallelShaderCompile) {
+        EnableParallelShaderCompile(GLEW_KHR_parallel_shader_compile != 0);
+    }
+
+    // Constantes partilhadas com os shaders: definidas só no C++ e injetadas em todas as fontes
+    char sharedDefines[64];
+    std::snprintf(sharedDefines, sizeof(sharedDefines), "#define SEAM_U %.9g\n", ObjModel::SEAM_U);
+    SetShaderDefines(sharedDefines);
+    return true;
+}
+
+/**
+ * Copia o snapshot mais recente da simulação para o estado da renderização
+ * Só as transformações que mudaram são escritas, para não invalidar o minimapa sem razão
+ */
+void applySnapshot() {
+    if (!simulation.acquireLatest()) return;
+    const SceneSnapshot& snapshot = simulation.latest();
+
+    camera = snapshot.camera;
+    lighting.isAmbientLightOn = snapshot.ambientLightOn;
+
+    for (size_t i = 0; i < bolas.size() && i < snapshot.balls.size(); ++i) {
+        const BallState& ball = snapshot.balls[i];
+        if (ball.position != bolas[i]->getPosition()) {
+            bolas[i]->setPosition(ball.position);
+        }
+        if (ball.orientation != bolas[i]->getOrientation()) {
+            bolas[i]->setOrientation(ball.orientation);
+        }
+    }
+}
+
+/**
+ * Tempo médio de GPU de um scope, ou -1 se ainda não foi medido
+ */
+double gpuScopeMs(const char* path) {
+    const GpuScopeStats* stats = gpuProfiler.find(path);
+    return stats ? stats->averageMs : -1.0;
+}
+
+/**
+ * Recolhe os valores mostrados pelo painel de desempenho
+ */
+PerfCounters collectPerfCounters() {
+    PerfCounters counters;
+    counters.drawCalls = renderQueue.drawCalls;
+    counters.triangles = renderQueue.triangles;
+    counters.textureBytes = GpuMemory::getTextureBytes();
+    counters.bufferBytes = GpuMemory::getBufferBytes();
+    counters.gpuFrameMs = gpuScopeMs("frame");
+    counters.mainPassMs = gpuScopeMs("frame/render_queue/principal");
+    counters.minimapPassMs = gpuScopeMs("frame/render_queue/minimapa");
+    return counters;
+}
+
+/**
+ * Desenha um frame completo (vista principal e minimapa)
+ * @param outputFramebuffer Framebuffer onde a imagem final é composta (0 = janela)
+ */
+void renderFrame(GLuint outputFramebuffer) {
+    PROFILE_ZONE("renderFrame");
+    const double frameStart = nowSeconds();
+    perfOverlay.beginFrame(frameStart);
+    dynamicResolution.beginFrame();
+    gpuProfiler.beginFrame();
+    gpuProfiler.beginScope("frame");
+
+    // Desenha sempre o estado completo mais recente da simulação
+    applySnapshot();
+
+    // Atualiza estado da iluminação
+    const glm::vec3 finalAmbientLight = lighting.isAmbientLightOn ? lighting.ambientLight * lighting.ambientIntensity : glm::vec3(0.0f);
+
+    // Configura estado comum do OpenGL (a luz ambiente é partilhada por todas as variantes)
+    glProgramUniform3fv(texturedProgram, texturedAmbientLightLoc, 1, glm::value_ptr(finalAmbientLight));
+    glProgramUniform3fv(sphereProgram, sphereAmbientLightLoc, 1, glm::value_ptr(finalAmbientLight));
+    glProgramUniform3fv(vertexColorProgram, vertexColorAmbientLightLoc, 1, glm::value_ptr(finalAmbientLight));
+    if (ballImpostor.isReady()) {
+        glProgramUniform3fv(ballImpostor.getProgram(), impostorAmbientLightLoc, 1, glm::value_ptr(finalAmbientLight));
+    }
+    if (multiDraw.isReady()) {
+        glProgramUniform3fv(multiDraw.getProgram(), mdiAmbientLightLoc, 1, glm::value_ptr(finalAmbientLight));
+    }
+    glEnable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    renderQueue.clear();
+    streamBuffer.beginFrame();
+
+    // Recalcula as matrizes de modelo alteradas desde o último frame
+    transforms.update();
+
+    // Atualiza as esferas envolventes partilhadas pelas duas vistas
+    ballBounds.clear();
+    for (const auto* bola : bolas) {
+        ballBounds.add(bola->getPosition(), bola->getBoundingRadius());
+    }
+
+    // Regista as vistas do frame antes de construir as listas (a fila fica só de leitura)
+    frameViews.clear();
+
+    // Vista principal, desenhada no alvo de resolução dinâmica
+    {
+        RenderView mainView;
+        mainView.width = dynamicResolution.getRenderWidth();
+        mainView.height = dynamicResolution.getRenderHeight();
+        mainView.framebuffer = dynamicResolution.getFramebuffer();
+        mainView.clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+        mainView.name = "principal";
+        mainView.view = camera.getViewMatrix();
+        mainView.projection = camera.getProjectionMatrix(static_cast<float>(WIDTH) / HEIGHT);
+        const uint8_t viewId = renderQueue.addView(mainView);
+        if (viewId != RenderQueue::INVALID_VIEW) frameViews.push_back(viewId);
+    }
+
+    // Versão da cena vista pelo minimapa: muda quando uma bola se move ou uma luz muda
+    const unsigned long long sceneVersion = (transforms.getChangeCount() << 2) | (pointLightsOn ? 2 : 0) | (lighting.isAmbientLightOn ? 1 : 0);
+
+    // Minimapa para a sua textura, apenas quando a cena mudou
+    if (minimap.shouldRefresh(frameStart, sceneVersion)) {
+        RenderView miniView;
+        miniView.width = MINIMAP_SIZE;
+        miniView.height = MINIMAP_SIZE;
+        miniView.view = topDownCamera.getViewMatrix();
+        miniView.projection = topDownCamera.getProjectionMatrix(1.0f);
+        miniView.framebuffer = minimap.getTarget().getFramebuffer();
+        miniView.clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+        miniView.name = "minimapa";
+        const uint8_t viewId = renderQueue.addView(miniView);
+        if (viewId != RenderQueue::INVALID_VIEW) frameViews.push_back(viewId);
+    }
+
+    // Constrói as listas de desenho de todas as vistas em paralelo
+    display(frameViews);
+
+    // Distribui as luzes pontuais pelos clusters das mesmas vistas
+    static const std::vector<PointLight> noLights;
+    clusteredLighting.update(pointLightsOn ? pointLights : noLights, renderQueue, frameViews, taskPool);
+
+    // Ordena os pacotes das vistas e desenha
+    {
+        PROFILE_ZONE("RenderQueue::sort");
+        renderQueue.sort();
+    }
+    {
+        PROFILE_ZONE("RenderQueue::execute");
+        pipelineStats.begin();
+        gpuProfiler.beginScope("render_queue");
+        renderQueue.execute();
+        gpuProfiler.endScope();
+        pipelineStats.end();
+    }
+
+    // A região do buffer circular usada por este frame fica protegida até a GPU a ler
+    streamBuffer.endFrame();
+
+    // Amplia a vista principal para o destino final
+    {
+        GpuScope scope(gpuProfiler, "upscale");
+        dynamicResolution.present(outputFramebuffer);
+    }
+
+    // Copia o minimapa em cache para o canto
+    {
+        GpuScope scope(gpuProfiler, "minimap_present");
+        minimap.present(WIDTH - MINIMAP_SIZE - MINIMAP_PADDING, HEIGHT - MINIMAP_SIZE - MINIMAP_PADDING, outputFramebuffer);
+    }
+
+    // Painel de desempenho por cima da imagem final (uma chamada de desenho)
+    if (perfOverlay.isEnabled()) {
+        GpuScope scope(gpuProfiler, "overlay");
+        perfOverlay.draw(collectPerfCounters(), outputFramebuffer);
+    }
+
+    gpuProfiler.endScope();
+    gpuProfiler.endFrame();
+
+    // Ajusta a escala do próximo frame (o tempo de CPU exclui a espera do vsync)
+    dynamicResolution.endFrame((nowSeconds() - frameStart) * 1000.0);
+}
+
+/**
+ * Liberta os recursos da cena
+ */
+void shutdown() {
+    // Resumo da captura (stop() espera pelos frames ainda em voo)
+    if (frameCapture.isActive()) {
+        frameCapture.stop();
+        std::cout << "Captura: " << frameCapture.getCapturedFrames() << " frames gravados, "
+            << frameCapture.getDroppedFrames() << " descartados, "
+            << frameCapture.getAverageCaptureMs() << " ms por frame no ciclo principal" << std::endl;
+    }
+
+    // Resumo das estatísticas do pipeline
+    if (pipelineStats.hasResults()) {
+        std::cout << "Ultimo frame medido: " << pipelineStats.getVertexInvocations() << " invocacoes de vertices, "
+            << pipelineStats.getFragmentInvocations() << " de fragmentos" << std::endl;
+    }
+    if (streamBuffer.isReady()) {
+        std::cout << "Buffer circular: " << streamBuffer.getStallCount() << " esperas ("
+            << streamBuffer.getStallMs() << " ms), " << streamBuffer.getOverflowCount() << " pedidos sem espaco" << std::endl;
+    }
+    pipelineStats.destroy();
+    gpuProfiler.destroy();
+    perfOverlay.destroy();
+    ballImpostor.destroy();
+    clusteredLighting.destroy();
+    multiDraw.destroy();
+    minimap.destroy();
+    dynamicResolution.destroy();
+    streamBuffer.destroy();
+    shaderVariants.destroy();
+    taskPool.shutdown();
+
+    for (auto* bola : bolas) {
+        delete bola;
+    }
+    bolas.clear();
+}
+
+/**
+ * Modo headless: desenha N frames num framebuffer próprio, sem janela,
+ * e escreve as estatísticas de tempo no stdout
+ *
+ * Com --bench, a câmera faz uma volta completa à cena ao longo dos N
+ * frames (a mesma em todas as execuções) e o resultado é gravado em JSON.
  */
-int main(void) {
-    // Inicializa a cmera antes de criar a janela
+int runHeadless(const CommandLine& options) {
+    HeadlessContext context;
+    if (!context.create(WIDTH, HEIGHT)) {
+        return -1;
+    }
+    if (!initGL(options.programCache)) {
+        return -1;
+    }
+
+    const double loadStart = nowSeconds();
+    init();
+    const double loadMs = (nowSeconds() - loadStart) * 1000.0;
+
+    // Escala fixa: os resultados têm de ser comparáveis entre execuções
+    dynamicResolution.setEnabled(false);
+
+    RenderTarget output;
+    if (!output.create(WIDTH, HEIGHT)) {
+        std::cerr << "Falha ao criar framebuffer de saida" << std::endl;
+        return -1;
+    }
+    if (!options.capturePath.empty()) {
+        frameCapture.start(WIDTH, HEIGHT, options.capturePath);
+    }
+
+    // Cada frame termina com glFinish para medir o trabalho real da GPU
+    const bool bench = !options.benchPath.empty();
+    const float orbitStep = glm::two_pi<float>() / options.frames;
+    std::vector<double> frameMs;
+    frameMs.reserve(options.frames);
+    double buildMs = 0.0;
+    unsigned long long drawCalls = 0, triangles = 0, visibleObjects = 0;
+    const double start = nowSeconds();
+    for (int frame = 0; frame < options.frames; ++frame) {
+        const double frameStart = nowSeconds();
+        if (bench) {
+            simulation.pushInput({ InputEvent::ORBIT, orbitStep });
+        }
+        simulation.step(HEADLESS_STEP);
+        renderFrame(output.getFramebuffer());
+        frameCapture.capture(output.getFramebuffer());
+        glFinish();
+        frameMs.push_back((nowSeconds() - frameStart) * 1000.0);
+        buildMs += renderListBuildMs;
+        drawCalls += renderQueue.drawCalls;
+        triangles += renderQueue.triangles;
+        visibleObjects += viewCullStats[frameViews[0]].visible;
+    }
+    const double totalSeconds = nowSeconds() - start;
+
+    const double minMs = *std::min_element(frameMs.begin(), frameMs.end());
+    const double maxMs = *std::max_element(frameMs.begin(), frameMs.end());
+    const double avgMs = totalSeconds * 1000.0 / options.frames;
+
+    std::cout << "backend: " << context.getBackend() << std::endl;
+    std::cout << "renderer: " << glCaps.renderer << std::endl;
+    std::cout << "resolution: " << WIDTH << "x" << HEIGHT << std::endl;
+    std::cout << "frames: " << options.frames << std::endl;
+    std::cout << "total_s: " << totalSeconds << std::endl;
+    std::cout << "avg_ms: " << avgMs << std::endl;
+    std::cout << "min_ms: " << minMs << std::endl;
+    std::cout << "max_ms: " << maxMs << std::endl;
+    std::cout << "fps: " << options.frames / totalSeconds << std::endl;
+    std::cout << "build_ms: " << buildMs / options.frames << std::endl;
+    std::cout << "worker_threads: " << taskPool.getWorkerCount() << std::endl;
+    if (const GpuScopeStats* gpuFrame = gpuProfiler.find("frame")) {
+        std::cout << "gpu_ms: " << gpuFrame->averageMs << std::endl;
+    }
+
+    if (!options.gpuProfilePath.empty() && !gpuProfiler.dump(options.gpuProfilePath)) {
+        std::cerr << "Falha ao gravar tempos de GPU em " << options.gpuProfilePath << std::endl;
+    }
+
+    int result = 0;
+    if (bench) {
+        BenchmarkReport report;
+        report.renderer = glCaps.renderer;
+        report.backend = context.getBackend();
+        report.width = WIDTH;
+        report.height = HEIGHT;
+        report.scene = sceneConfig;
+        report.impostors = ballImpostors;
+        report.balls = bolas.size();
+        report.modelsLoaded = std::count_if(bolas.begin(), bolas.end(), [](const ObjModel* bola) { return !bola->isInstance(); });
+        report.loadMs = loadMs;
+        report.frameMs = frameMs;
+        report.gpuMs = gpuScopeMs("frame");
+        report.drawCalls = static_cast<double>(drawCalls) / options.frames;
+        report.triangles = static_cast<double>(triangles) / options.frames;
+        report.visibleObjects = static_cast<double>(visibleObjects) / options.frames;
+        report.textureBytes = GpuMemory::getTextureBytes();
+        report.bufferBytes = GpuMemory::getBufferBytes();
+        report.workerThreads = taskPool.getWorkerCount();
+        if (report.write(options.benchPath)) {
+            std::cout << "bench: " << options.benchPath << std::endl;
+        }
+        else {
+            std::cerr << "Falha ao gravar relatorio em " << options.benchPath << std::endl;
+            result = -1;
+        }
+    }
+    if (!options.dumpPath.empty()) {
+        if (saveFramebufferPPM(output.getFramebuffer(), WIDTH, HEIGHT, options.dumpPath)) {
+            std::cout << "image: " << options.dumpPath << std::endl;
+        }
+        else {
+            result = -1;
+        }
+    }
+
+    output.destroy();
+    shutdown();
+    return result;
+}
+
+/**
+ * Termina o registo de zonas de CPU e grava o ficheiro pedido com --trace
+ */
+void writeTrace(const CommandLine& options) {
+    if (options.tracePath.empty()) {
+        return;
+    }
+
+    CpuProfiler::stop();
+    if (CpuProfiler::writeChromeTrace(options.tracePath)) {
+        std::cout << "Trace: " << CpuProfiler::getEventCount() << " eventos gravados em " << options.tracePath << std::endl;
+    }
+    else {
+        std::cerr << "Falha ao gravar trace em " << options.tracePath << std::endl;
+    }
+}
+
+/**
+ * Função principal
+ * Ponto de entrada da aplicação, configura o ambiente OpenGL e executa o loop principal
+ */
+int main(int argc, char** argv) {
+    CommandLine options;
+    if (!parseCommandLine(argc, argv, options)) {
+        return -1;
+    }
+
+    // Os cenários de regressão correm em processos filhos; este só os lança e compara
+    if (!options.regressionPath.empty()) {
+        return RegressionHarness::run(argv[0], options.regressionPath, options.updateBaseline);
+    }
+
+    sceneConfig = options.scene;
+    ballImpostors = options.impostors;
+
+    // As zonas só são registadas depois de start(), para não pagar o custo sem --trace
+    PROFILE_THREAD("principal");
+    if (!options.tracePath.empty()) {
+        CpuProfiler::start();
+    }
+
+    // Inicializa a câmera antes de criar a janela
     camera.updatePosition();
 
+    if (options.headless) {
+        int result = runHeadless(options);
+        writeTrace(options);
+        return result;
+    }
+
     // Inicializa GLFW e cria a janela
     GLFWwindow* window;
     glfwSetErrorCallback(print_error);
@@ -193,12 +827,8 @@ int main(void) {
         return -1;
     }
 
-    // Cria contexto OpenGL 3.3 core profile
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    window = glfwCreateWindow(WIDTH, HEIGHT, "Bilhar", nullptr, nullptr);
+    // Cria o contexto OpenGL core profile da versão mais alta disponível
+    window = createWindow();
     if (!window) {
         std::cerr << "Falha ao criar janela GLFW" << std::endl;
         glfwTerminate();
@@ -207,10 +837,7 @@ int main(void) {
 
     glfwMakeContextCurrent(window);
 
-    // Inicializa GLEW
-    glewExperimental = GL_TRUE; // Habilita recursos modernos do OpenGL
-    if (glewInit() != GLEW_OK) {
-        std::cerr << "Falha ao inicializar GLEW" << std::endl;
+    if (!initGL(options.programCache)) {
         return -1;
     }
 
@@ -223,71 +850,59 @@ int main(void) {
     // Inicializa estado do OpenGL e recursos
     init();
 
-    // Armazena localizaes de uniforms para melhor performance
-    const GLint ambientLightLoc = glGetUniformLocation(program, "ambientLight");
-    const GLint textureLoc = glGetUniformLocation(program, "tex");
-    const GLint mvpLoc = glGetUniformLocation(program, "MVP");
-
-    // Loop principal de renderizao
-    while (!glfwWindowShouldClose(window)) {
-        // Atualiza estado da iluminao
-        const glm::vec3 finalAmbientLight = lighting.isAmbientLightOn ? lighting.ambientLight * lighting.ambientIntensity : glm::vec3(0.0f);
+    if (!options.capturePath.empty()) {
+        frameCapture.start(WIDTH, HEIGHT, options.capturePath);
+    }
 
-        // Configura estado comum do OpenGL
-        glUseProgram(program);
-        glUniform1i(textureLoc, 0);
-        glUniform3fv(ambientLightLoc, 1, glm::value_ptr(finalAmbientLight));
-        glEnable(GL_DEPTH_TEST);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // A simulação avança ao seu ritmo, independente da renderização
+    simulation.start(SIMULATION_HZ);
 
-        // Matrizes de transformao comuns
-        const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0, -2, 0));
+    // Ritmo dos frames: o intervalo esperado com vsync vem da frequência do ecrã
+    const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    framePacer.init(options.pacing, options.targetFps, videoMode ? videoMode->refreshRate : 60.0);
 
-        // Renderiza vista principal
+    // Loop principal de renderização
+    while (!glfwWindowShouldClose(window)) {
+        PROFILE_ZONE("frame");
+        framePacer.beginFrame();
+        renderFrame(0);
         {
-            glViewport(0, 0, WIDTH, HEIGHT);
-            const glm::mat4 view = camera.getViewMatrix();
-            const glm::mat4 projection = camera.getProjectionMatrix(static_cast<float>(WIDTH) / HEIGHT);
-            const glm::mat4 mvp = projection * view * model;
-
-            glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp));
-            display(view, projection);
+            PROFILE_ZONE("capture");
+            frameCapture.capture(0);
         }
-
-        // Renderiza minimapa
         {
-            constexpr int MINIMAP_BORDER = 10;
-            glViewport(
-                WIDTH - MINIMAP_SIZE - MINIMAP_BORDER,
-                HEIGHT - MINIMAP_SIZE - MINIMAP_BORDER,
-                MINIMAP_SIZE,
-                MINIMAP_SIZE
-            );
-
-            const glm::mat4 miniView = topDownCamera.getViewMatrix();
-            const glm::mat4 miniProj = topDownCamera.getProjectionMatrix(1.0f);
-            const glm::mat4 miniMVP = miniProj * miniView * model;
-
-            glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(miniMVP));
-            display(miniView, miniProj);
+            PROFILE_ZONE("present");
+            framePacer.waitForPresent();
+            glfwSwapBuffers(window);
+            framePacer.endFrame();
+        }
+        {
+            PROFILE_ZONE("pollEvents");
+            glfwPollEvents();
         }
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
-    // Cleanup
-    for (auto* bola : bolas) {
-        delete bola;
+    simulation.stop();
+    framePacer.report(std::cout);
+    framePacer.shutdown();
+    if (!options.gpuProfilePath.empty() && !gpuProfiler.dump(options.gpuProfilePath)) {
+        std::cerr << "Falha ao gravar tempos de GPU em " << options.gpuProfilePath << std::endl;
     }
-    bolas.clear();
+    shutdown();
+    writeTrace(options);
 
     glfwTerminate();
     return 0;
 }
 
-void createBall(const std::string& modelPath, const glm::vec3& position) {
-    ObjModel* bola = new ObjModel(modelPath);
+/**
+ * Cria uma bola: lê o modelo do disco, ou partilha a geometria e os materiais de um protótipo
+ * @param modelPath Caminho do .obj (ignorado com protótipo)
+ * @param position Posição da bola no mundo
+ * @param prototype Bola já carregada do mesmo tipo (nullptr = carregar do disco)
+ */
+void createBall(const std::string& modelPath, const glm::vec3& position, const ObjModel* prototype = nullptr) {
+    ObjModel* bola = prototype ? new ObjModel(*prototype, transforms) : new ObjModel(modelPath, transforms);
     bola->setPosition(position);
     bola->setScale(vec3(0.5f));
     bolas.push_back(bola);
@@ -295,27 +910,57 @@ void createBall(const std::string& modelPath, const glm::vec3& position) {
 
 /**
  * Inicializa recursos do OpenGL
- * Configura a geometria da mesa de bilhar com cada face tendo uma cor slida distinta
+ * Configura a geometria da mesa de bilhar com cada face tendo uma cor sólida distinta
  */
 void init(void) {
+    PROFILE_ZONE("init");
+
     glEnable(GL_DEPTH_TEST);
 
-    // Dimenses da mesa
-    constexpr GLfloat tableWidth = 9.0f;
-    constexpr GLfloat tableHeight = 0.5f;
-    constexpr GLfloat tableDepth = 5.5f;
-
-    // Posies das bolas (mantidas iguais)
-    glm::vec3 ballsPosition[15] = {
-        {-1.0f, -1.0f, 0.0f},
-        {-1.8f, -1.0f, 0.5f}, {-1.8f, -1.0f, -0.5f},
-        {-2.6f, -1.0f, 1.0f}, {-2.6f, -1.0f, 0.0f}, {-2.6f, -1.0f, -1.0f},
-        {-3.4f, -1.0f, 1.5f}, {-3.4f, -1.0f, 0.5f}, {-3.4f, -1.0f, -0.5f}, {-3.4f, -1.0f, -1.5f},
-        {-4.2f, -1.0f, 2.0f}, {-4.2f, -1.0f, 1.0f}, {-4.2f, -1.0f, 0.0f}, {-4.2f, -1.0f, -1.0f}, {-4.2f, -1.0f, -2.0f}
-    };
+    // Pede já a compilação de todos os programas e variantes: com compilação
+    // paralela, o driver compila enquanto a mesa, as bolas e as texturas são carregadas
+    shaderVariants.setSources("shader.vert", "shader.frag", "lighting.frag", "sphereuv.frag");
+    shaderVariants.request(SHADER_TEXTURED);
+    shaderVariants.request(SHADER_TEXTURED | SHADER_SPHERE_UV);
+    shaderVariants.request(SHADER_VERTEX_COLOR);
+    shaderVariants.request(SHADER_DEPTH_ONLY);
+    shaderVariants.request(SHADER_TEXTURED | SHADER_IMPOSTOR);
+    shaderVariants.request(SHADER_DEPTH_ONLY | SHADER_IMPOSTOR);
+    if (glCaps.canMultiDraw()) {
+        // As bolas são esferas (vértices só com posição); se não forem, build() volta a pedir o programa
+        multiDraw.requestProgram(glCaps.bindlessTexture, true);
+    }
 
-    // Agora definimos 24 vrtices (4 vrtices por face  6 faces)
-    // Cada face ter seus prprios vrtices para permitir cores uniformes
+    // Posições das mesas e das bolas (por omissão, uma mesa com o triângulo de 15 bolas)
+    const SceneLayout layout = StressScene::generate(sceneConfig, tablePosition, glm::vec3(tableWidth, tableHeight, tableDepth));
+    tablePositions = layout.tables;
+
+    // Luzes pontuais: candeeiros de luz quente por cima das mesas e luzes de destaque coloridas e curtas
+    pointLights.clear();
+    for (const glm::vec3& lamp : layout.lamps) {
+        PointLight light;
+        light.position = lamp;
+        light.color = glm::vec3(1.0f, 0.85f, 0.6f);
+        light.intensity = 1.5f;
+        light.radius = 12.0f;
+        pointLights.push_back(light);
+    }
+    for (size_t i = 0; i < layout.accents.size(); ++i) {
+        const float hue = glm::two_pi<float>() * std::fmod(i * 0.618034f, 1.0f);
+        PointLight light;
+        light.position = layout.accents[i];
+        light.color = glm::clamp(glm::vec3(std::cos(hue), std::cos(hue - 2.0944f), std::cos(hue + 2.0944f)) * 0.5f + 0.5f, 0.0f, 1.0f);
+        light.intensity = 2.0f;
+        light.radius = 4.0f;
+        pointLights.push_back(light);
+    }
+    tableMaterial.ka = glm::vec3(0.3f);
+    tableMaterial.kd = glm::vec3(0.8f);
+    tableMaterial.ks = glm::vec3(0.05f);
+    tableMaterial.ns = 8.0f;
+
+    // Agora definimos 24 vértices (4 vértices por face × 6 faces)
+    // Cada face terá seus próprios vértices para permitir cores uniformes
     const GLfloat vertices[24][3] = {
         // Face Frente (Z+) - Vermelha
         {-tableWidth,  tableHeight,  tableDepth}, // 0
@@ -354,7 +999,7 @@ void init(void) {
         { tableWidth, -tableHeight, -tableDepth}  // 23
     };
 
-    // Cores para cada face (4 vrtices por face com a mesma cor)
+    // Cores para cada face (4 vértices por face com a mesma cor)
     GLfloat colors[24][3];
 
     // Face Frente - Vermelha
@@ -387,7 +1032,7 @@ void init(void) {
         colors[i][0] = 0.0f; colors[i][1] = 1.0f; colors[i][2] = 1.0f;
     }
 
-    // ndices para as 6 faces (cada face usa 2 tringulos = 6 ndices)
+    // Índices para as 6 faces (cada face usa 2 triângulos = 6 índices)
     const GLuint indices[36] = {
         // Face Frente
         0, 1, 2,   1, 3, 2,
@@ -413,35 +1058,30 @@ void init(void) {
 
     glGenBuffers(NumBuffers, Buffers);
 
-    // Buffer de posies dos vrtices
+    // Buffer de posições dos vértices
     glBindBuffer(GL_ARRAY_BUFFER, Buffers[0]);
     glBufferStorage(GL_ARRAY_BUFFER, sizeof(vertices), vertices, 0);
 
-    // Buffer de cores dos vrtices
+    // Buffer de cores dos vértices
     glBindBuffer(GL_ARRAY_BUFFER, Buffers[1]);
     glBufferStorage(GL_ARRAY_BUFFER, sizeof(colors), colors, 0);
 
-    // Buffer de ndices
+    // Buffer de índices
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Buffers[2]);
     glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, 0);
+    GpuMemory::addBuffer(sizeof(vertices) + sizeof(colors) + sizeof(indices));
 
-    // Carrega e compila shaders
-    ShaderInfo shaders[] = {
-        { GL_VERTEX_SHADER,   "shader.vert" },
-        { GL_FRAGMENT_SHADER, "shader.frag" },
-        { GL_NONE, NULL }
-    };
-
-    program = LoadShaders(shaders);
-    if (!program) {
-        std::cerr << "Falha ao carregar shaders" << std::endl;
-        exit(EXIT_FAILURE);
+    if (glCaps.pipelineStatistics) {
+        pipelineStats.init();
     }
-    glUseProgram(program);
 
-    // Configura atributos dos vrtices
-    const GLint coordsId = glGetProgramResourceLocation(program, GL_PROGRAM_INPUT, "vPosition");
-    const GLint colorsId = glGetProgramResourceLocation(program, GL_PROGRAM_INPUT, "vColors");
+    // Queries de tempo dos scopes de GPU (vista, pass, mesa/bolas)
+    gpuProfiler.init();
+    renderQueue.setProfiler(&gpuProfiler);
+
+    // Configura atributos dos vértices (localizações fixas em shader.vert, sem esperar pelo link)
+    const GLint coordsId = 0;  // vPosition
+    const GLint colorsId = 3;  // vColors
 
     glBindBuffer(GL_ARRAY_BUFFER, Buffers[0]);
     glVertexAttribPointer(coordsId, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
@@ -452,50 +1092,284 @@ void init(void) {
     glEnableVertexAttribArray(coordsId);
     glEnableVertexAttribArray(colorsId);
 
-    // Inicializa cmera superior para o minimapa
+    // Painel de desempenho (escondido até ser pedido com a tecla 5; cria o seu próprio VAO,
+    // por isso só depois de configurar o VAO da mesa)
+    if (!perfOverlay.init(WIDTH, HEIGHT)) {
+        std::cerr << "Falha ao criar o painel de desempenho" << std::endl;
+    }
+
+    // Inicializa câmera superior para o minimapa
     topDownCamera.position = glm::vec3(0.0f, 30.0f, 0.0f);
     topDownCamera.target = glm::vec3(0.0f, 0.0f, 0.0f);
     topDownCamera.up = glm::vec3(0.0f, 0.0f, -1.0f);
     topDownCamera.fov = 45.0f;
 
-    // Carrega modelos das bolas de bilhar
+    // Cria a textura onde o minimapa é guardado
+    if (!minimap.init(MINIMAP_SIZE, MINIMAP_MAX_REFRESH_HZ)) {
+        std::cerr << "Falha ao criar framebuffer do minimapa" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Cria o alvo da vista principal com a resolução máxima
+    if (!dynamicResolution.init(WIDTH, HEIGHT, FRAME_BUDGET_MS, MIN_RESOLUTION_SCALE)) {
+        std::cerr << "Falha ao criar framebuffer da vista principal" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Carrega modelos das bolas de bilhar: com partilha de malhas, só a primeira bola de cada tipo é lida do disco
+    ObjModel::setTextureSharing(sceneConfig.sharing != SHARE_NONE);
     try {
-        for (int i = 0; i < 15; ++i) {
-            createBall("PoolBalls/ball" + std::to_string(i + 1) + ".obj", ballsPosition[i]);
+        bool variantsPending = true;
+        std::vector<const ObjModel*> prototypes(StressScene::BALL_TYPES, nullptr);
+        for (size_t i = 0; i < layout.balls.size(); ++i) {
+            const int type = layout.ballTypes[i];
+            const ObjModel* prototype = sceneConfig.sharing == SHARE_MESHES ? prototypes[type] : nullptr;
+            createBall("PoolBalls/Ball" + std::to_string(type + 1) + ".obj", layout.balls[i], prototype);
+            if (!prototypes[type]) {
+                prototypes[type] = bolas.back();
+            }
+
+            // Entre bolas, conclui as variantes que o driver já compilou (sem bloquear)
+            if (variantsPending) variantsPending = shaderVariants.finishReady() != 0;
         }
     }
     catch (const std::exception& e) {
         std::cerr << "Falha ao carregar modelos das bolas: " << e.what() << std::endl;
         exit(EXIT_FAILURE);
     }
+
+    // Conclui as variantes que ainda faltam (só estas podem esperar pelo driver)
+    texturedProgram = shaderVariants.get(SHADER_TEXTURED);
+    sphereProgram = shaderVariants.get(SHADER_TEXTURED | SHADER_SPHERE_UV);
+    vertexColorProgram = shaderVariants.get(SHADER_VERTEX_COLOR);
+    if (!texturedProgram || !sphereProgram || !vertexColorProgram) {
+        std::cerr << "Falha ao carregar shaders" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Variante do pre-pass de profundidade (a posição usa a mesma localização 0)
+    depthProgram = shaderVariants.get(SHADER_DEPTH_ONLY);
+    if (!depthProgram) {
+        std::cerr << "Falha ao carregar shaders do pre-pass" << std::endl;
+    }
+    renderQueue.setDepthPrepass(true, depthProgram);
+
+    // Impostores das bolas: sem eles, --impostors e a tecla 6 não têm efeito
+    if (!ballImpostor.init(shaderVariants.get(SHADER_TEXTURED | SHADER_IMPOSTOR), shaderVariants.get(SHADER_DEPTH_ONLY | SHADER_IMPOSTOR))) {
+        std::cerr << "Falha ao carregar shaders dos impostores" << std::endl;
+        ballImpostors = false;
+    }
+
+    // Agrupa as bolas para submissão por multi-draw indireto, se suportado (as instâncias usam a malha do protótipo).
+    // Texturas: bindless se existir, senão array de texturas; sem multi-draw, uma ligação por desenho.
+    std::vector<ObjModel*> meshes;
+    for (auto* bola : bolas) {
+        if (!bola->isInstance()) meshes.push_back(bola);
+    }
+    if (glCaps.canMultiDraw() && multiDraw.build(meshes, glCaps.bindlessTexture)) {
+        renderQueue.setMultiDraw(&multiDraw);
+        std::cout << "Texturas das bolas: " << (multiDraw.isBindless() ? "bindless" : "array de texturas") << std::endl;
+    }
+
+    // Regista programas e texturas na fila: a construção paralela das listas só a lê
+    renderQueue.registerState(vertexColorProgram, 0);
+    for (const auto* bola : bolas) {
+        renderQueue.registerState(ballProgram(bola), bola->getDiffuseTexture());
+        if (ballImpostor.isReady()) {
+            renderQueue.registerState(ballImpostor.getProgram(), bola->getDiffuseTexture());
+        }
+    }
+    if (ballImpostor.isReady()) {
+        renderQueue.registerState(ballImpostor.getDepthProgram(), 0);
+    }
+
+    // Threads de trabalho para a construção das listas (a thread do OpenGL também participa)
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    taskPool.init(hardwareThreads > 2 ? std::min(hardwareThreads - 2, 7u) : 0u);
+
+    // Estado inicial da simulação: câmera, luz e bolas tal como foram criadas
+    std::vector<BallState> initialBalls(bolas.size());
+    for (size_t i = 0; i < bolas.size(); ++i) {
+        initialBalls[i].position = bolas[i]->getPosition();
+        initialBalls[i].orientation = bolas[i]->getOrientation();
+    }
+    // Cenas com várias mesas: a órbita da câmera passa a envolvê-las todas
+    if (layout.radius > camera.orbitRadius) {
+        camera.orbitRadius = layout.radius * 1.2f;
+        camera.height = std::min(camera.orbitRadius * 0.5f, MAX_HEIGHT);
+        camera.updatePosition();
+    }
+
+    CameraLimits limits;
+    limits.minFov = MIN_FOV;
+    limits.maxFov = MAX_FOV;
+    limits.minHeight = MIN_HEIGHT;
+    limits.maxHeight = MAX_HEIGHT;
+    simulation.init(camera, lighting.isAmbientLightOn, initialBalls, limits);
+
+    // Buffer circular persistente para os dados por frame do multi-draw (3 frames em voo)
+    if (multiDraw.isReady() && glCaps.bufferStorage && streamBuffer.init(STREAM_REGION_SIZE, 3)) {
+        multiDraw.setStreamBuffer(&streamBuffer);
+    }
+
+    // Armazena localizações de uniforms para melhor performance
+    texturedAmbientLightLoc = glGetUniformLocation(texturedProgram, "ambientLight");
+    vertexColorAmbientLightLoc = glGetUniformLocation(vertexColorProgram, "ambientLight");
+    glProgramUniform1i(texturedProgram, glGetUniformLocation(texturedProgram, "tex"), 0);
+    sphereAmbientLightLoc = glGetUniformLocation(sphereProgram, "ambientLight");
+    glProgramUniform1i(sphereProgram, glGetUniformLocation(sphereProgram, "tex"), 0);
+    if (ballImpostor.isReady()) {
+        impostorAmbientLightLoc = glGetUniformLocation(ballImpostor.getProgram(), "ambientLight");
+        glProgramUniform1i(ballImpostor.getProgram(), glGetUniformLocation(ballImpostor.getProgram(), "tex"), 0);
+    }
+
+    // Iluminação clustered: as texturas das listas ficam nas unidades 1 a 3 de todos os programas com cor
+    if (clusteredLighting.init()) {
+        clusteredLighting.setupProgram(texturedProgram);
+        clusteredLighting.setupProgram(sphereProgram);
+        clusteredLighting.setupProgram(vertexColorProgram);
+        if (ballImpostor.isReady()) {
+            clusteredLighting.setupProgram(ballImpostor.getProgram());
+        }
+        if (multiDraw.isReady()) {
+            clusteredLighting.setupProgram(multiDraw.getProgram());
+        }
+        renderQueue.setLighting(&clusteredLighting);
+        std::cout << "Luzes pontuais: " << pointLights.size() << " (" << layout.lamps.size() << " candeeiros)" << std::endl;
+    }
+
+    if (programCache.isEnabled()) {
+        std::cout << "Cache de programas: " << programCache.getHits() << " carregados, "
+            << programCache.getMisses() + programCache.getRejected() << " compilados" << std::endl;
+    }
+    mdiAmbientLightLoc = multiDraw.isReady() ? glGetUniformLocation(multiDraw.getProgram(), "ambientLight") : -1;
 }
 
 /**
- * Renderiza a cena
- * @param view Matriz de visualizao da cmera atual
- * @param projection Matriz de projeo do viewport atual
+ * Constrói a lista de desenho de um intervalo de bolas de uma vista
+ * Corre numa thread de trabalho: só lê a cena e a fila, e escreve apenas na própria tarefa.
+ * Apenas os objetos cuja esfera envolvente interseta o frustum da vista são incluídos.
+ * @param task Vista, intervalo de bolas e lista de saída
  */
-void display(const glm::mat4& view, const glm::mat4& projection) {
-    // Obtm localizaes de uniforms
-    const GLint objectTypeLoc = glGetUniformLocation(program, "objectType");
-    const GLint hasTextureLoc = glGetUniformLocation(program, "hasTexture");
+void buildRenderList(BuildTask& task) {
+    PROFILE_ZONE("buildRenderList");
+
+    const RenderQueue& queue = renderQueue;
+    const RenderView& view = queue.getView(task.viewId);
 
-    // Desenha mesa de bilhar
-    glUniform1i(objectTypeLoc, 0);
-    glUniform1i(hasTextureLoc, false);
-    glDrawElements(GL_TRIANGLES, NumIndices, GL_UNSIGNED_INT, nullptr);
+    task.packets.clear();
 
-    // Desenha bolas de bilhar
-    glUniform1i(objectTypeLoc, 1);
-    glUniform1i(hasTextureLoc, true);
+    // Testa as bolas do intervalo em lotes SIMD
+    cullSpheres(task.frustum, ballBounds, task.begin, task.end, task.visible, task.stats);
 
-    // Renderiza todas as bolas do vetor
-    for (const auto& bola : bolas) {
-        bola->render(program, view, projection);
+    // Pacotes das bolas visíveis (a ordem de desenho é decidida depois pela chave)
+    // Os impostores só substituem as bolas com textura (a variante IMPOSTOR é TEXTURED)
+    for (uint32_t index : task.visible) {
+        if (ballImpostors && bolas[index]->getDiffuseTexture()) {
+            ballImpostor.record(queue, task.packets, task.viewId, *bolas[index]);
+        }
+        else {
+            bolas[index]->record(queue, task.packets, task.viewId, ballProgram(bolas[index]));
+        }
     }
 
-    // Restaura binding do VAO para o prximo frame
-    glBindVertexArray(VAO);
+    if (!task.includeTable) return;
+
+    // Cada mesa é um único objeto: teste escalar
+    const float tableRadius = glm::length(glm::vec3(tableWidth, tableHeight, tableDepth));
+    for (const glm::vec3& position : tablePositions) {
+        if (!task.frustum.intersectsSphere(position, tableRadius)) {
+            ++task.stats.culled;
+            continue;
+        }
+        ++task.stats.visible;
+
+        // Pacote da mesa de bilhar
+        RenderPacket table;
+        table.program = vertexColorProgram;
+        table.vao = VAO;
+        table.count = NumIndices;
+        table.indexed = true;
+        table.label = "mesa";
+        table.material = &tableMaterial;
+        table.model = glm::translate(glm::mat4(1.0f), position);
+
+        const glm::vec4 tableViewPos = view.view * glm::vec4(position, 1.0f);
+        queue.record(task.packets, table, task.viewId, PASS_OPAQUE, -tableViewPos.z);
+    }
+}
+
+/**
+ * Submete a cena de todas as vistas para a fila de renderização
+ * Cada vista é repartida em intervalos de bolas, construídos em paralelo pelas
+ * threads de trabalho; a thread do OpenGL só junta as listas prontas.
+ * @param viewIds Vistas já registadas na fila neste frame
+ */
+void display(const std::vector<uint8_t>& viewIds) {
+    PROFILE_ZONE("display");
+
+    const double start = nowSeconds();
+
+    // Divide o trabalho: uma ou mais tarefas por vista (a primeira de cada vista inclui as mesas)
+    size_t taskCount = 0;
+    for (uint8_t viewId : viewIds) {
+        const RenderView& view = renderQueue.getView(viewId);
+        const Frustum frustum = Frustum::fromViewProjection(view.projection * view.view);
+
+        uint32_t begin = 0;
+        do {
+            if (taskCount == buildTasks.size()) {
+                buildTasks.emplace_back();
+            }
+            BuildTask& task = buildTasks[taskCount++];
+            task.viewId = viewId;
+            task.frustum = frustum;
+            task.begin = begin;
+            task.end = std::min<uint32_t>(begin + BUILD_RANGE, static_cast<uint32_t>(ballBounds.count));
+            task.includeTable = (begin == 0);
+            begin = task.end;
+        } while (begin < ballBounds.count);
+    }
+
+    taskPool.parallelFor(taskCount, [](size_t i) { buildRenderList(buildTasks[i]); });
+
+    // Junta as listas pela ordem das tarefas e acumula as estatísticas de culling
+    for (uint8_t viewId : viewIds) {
+        viewCullStats[viewId] = CullStats();
+    }
+    for (size_t i = 0; i < taskCount; ++i) {
+        const BuildTask& task = buildTasks[i];
+        renderQueue.append(task.packets);
+        viewCullStats[task.viewId].visible += task.stats.visible;
+        viewCullStats[task.viewId].culled += task.stats.culled;
+    }
+
+    renderListBuildMs = (nowSeconds() - start) * 1000.0;
+}
+
+/**
+ * Cria a janela com o contexto OpenGL mais recente suportado
+ * Tenta as versões por ordem decrescente até 3.3, o mínimo exigido pelos shaders
+ * @return Janela criada, ou nullptr se nenhuma versão for suportada
+ */
+GLFWwindow* createWindow(void) {
+    static const int versions[][2] = { {4, 6}, {4, 5}, {4, 4}, {4, 3}, {3, 3} };
+
+    // As tentativas falhadas são esperadas; silencia os erros durante a procura
+    glfwSetErrorCallback(nullptr);
+
+    GLFWwindow* window = nullptr;
+    for (const auto& version : versions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(WIDTH, HEIGHT, "Bilhar", nullptr, nullptr);
+        if (window) break;
+    }
+
+    glfwSetErrorCallback(print_error);
+    return window;
 }
 
 /**
@@ -0,0 +1,28 @@
+#version 330 core
+
+// Mapeamento equirretangular das texturas PoolBalluv numa esfera (o mesmo dos .obj das bolas, ver ObjModel)
+// Ligado como fragment shader adicional às variantes texturadas com IMPOSTOR/SPHERE_UV de shader.frag e aos
+// programas de multi-draw com SPHERE_UV, que declaram sphereUV() e leem a sua textura com textureGrad.
+
+// Meridiano da costura: injetado pelo carregador de shaders a partir de ObjModel::SEAM_U (ver SetShaderDefines)
+#ifndef SEAM_U
+#error SEAM_U tem de ser definido por SetShaderDefines
+#endif
+
+const float PI = 3.14159265;
+
+/**
+ * Coordenadas equirretangulares de uma direção (normal da esfera no espaço do objeto) e as suas derivadas no ecrã
+ * Na costura u salta de 1 para 0; aí as derivadas de u deslocado meia volta são as contínuas,
+ * e são essas que escolhem o nível de mipmap. Tem de ser chamada em controlo de fluxo uniforme.
+ */
+vec2 sphereUV(vec3 normal, out vec2 gradX, out vec2 gradY) {
+    vec2 uv = vec2(fract(SEAM_U - atan(normal.z, normal.x) / (2.0 * PI)), 0.5 + asin(clamp(normal.y, -1.0, 1.0)) / PI);
+
+    float shiftedU = fract(uv.x + 0.5);
+    gradX = vec2(dFdx(uv.x), dFdx(uv.y));
+    gradY = vec2(dFdy(uv.x), dFdy(uv.y));
+    if (abs(dFdx(shiftedU)) < abs(gradX.x)) gradX.x = dFdx(shiftedU);
+    if (abs(dFdy(shiftedU)) < abs(gradY.x)) gradY.x = dFdy(shiftedU);
+    return uv;
+}
\ No newline at end of file
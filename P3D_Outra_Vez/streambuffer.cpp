@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Implementação do Buffer Circular Persistente
+ ***********************************************************************/
+
+#include "streambuffer.h"
+#include "gpumemory.h"
+#include <chrono>
+#include <iostream>
+
+bool StreamBuffer::init(GLsizeiptr size, int count) {
+    destroy();
+
+    regionSize = size;
+    regionCount = count < 1 ? 1 : (count > MAX_REGIONS ? MAX_REGIONS : count);
+    region = regionCount - 1;  // O primeiro beginFrame() passa para a região 0
+    used = 0;
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) uniformAlignment = alignment;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) storageAlignment = alignment;
+
+    // As regiões começam alinhadas ao maior alinhamento pedido pelos pontos de ligação
+    const GLsizeiptr maxAlignment = uniformAlignment > storageAlignment ? uniformAlignment : storageAlignment;
+    regionSize = (regionSize + maxAlignment - 1) & ~(maxAlignment - 1);
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, regionSize * regionCount, nullptr, flags);
+    GpuMemory::addBuffer(regionSize * regionCount);
+    mapped = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, regionSize * regionCount, flags));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (!mapped) {
+        std::cerr << "Buffer circular: falha ao mapear o buffer persistente" << std::endl;
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+void StreamBuffer::destroy() {
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    if (buffer) {
+        if (mapped) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &buffer);
+        GpuMemory::addBuffer(-static_cast<long long>(regionSize) * regionCount);
+        buffer = 0;
+    }
+    mapped = nullptr;
+}
+
+void StreamBuffer::beginFrame() {
+    if (!mapped) return;
+
+    region = (region + 1) % regionCount;
+    used = 0;
+
+    GLsync& fence = fences[region];
+    if (!fence) return;
+
+    // Caso normal: a GPU já terminou o frame que usou esta região
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        ++stallCount;
+        const auto start = std::chrono::steady_clock::now();
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        } while (status == GL_TIMEOUT_EXPIRED);
+        stallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::endFrame() {
+    if (!mapped) return;
+
+    if (fences[region]) glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamAllocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    StreamAllocation allocation;
+    if (!mapped) return allocation;
+
+    const GLsizeiptr start = (used + alignment - 1) & ~(alignment - 1);
+    if (start + size > regionSize) {
+        ++overflowCount;
+        return allocation;
+    }
+    used = start + size;
+
+    allocation.offset = region * regionSize + start;
+    allocation.data = mapped + allocation.offset;
+    allocation.size = size;
+    return allocation;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - GL/glew: buffers persistentes e fences
+ */
+#include <GL/glew.h>
+
+/**
+ * @brief Fatia de um StreamBuffer devolvida por allocate()
+ */
+struct StreamAllocation {
+    void* data = nullptr;     // Memória mapeada onde o CPU escreve (nullptr = sem espaço)
+    GLintptr offset = 0;      // Deslocamento da fatia dentro do buffer GL
+    GLsizeiptr size = 0;
+};
+
+/**
+ * @brief Buffer circular persistentemente mapeado para dados dinâmicos por frame
+ *
+ * Um único buffer, criado com glBufferStorage e mapeado uma vez com
+ * GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, é dividido em regiões,
+ * uma por frame em voo. Em cada frame o CPU escreve apenas na região
+ * atual, através de sub-alocações alinhadas (dados por instância,
+ * uniforms, comandos indiretos); no fim do frame a região é protegida
+ * por uma fence. Quando o anel volta a uma região, a fence indica se a
+ * GPU já terminou de a ler; se não terminou, o CPU espera e a espera é
+ * contada como um "stall".
+ *
+ * Sem glMapBufferRange/glBufferData por frame, o driver não tem de
+ * orfanizar nem sincronizar buffers.
+ */
+class StreamBuffer {
+public:
+    ~StreamBuffer() { destroy(); }
+
+    /**
+     * @brief Cria e mapeia o buffer
+     * @param regionSize Bytes disponíveis por frame
+     * @param regionCount Frames em voo (regiões do anel)
+     * @return false se o buffer não pôde ser mapeado
+     */
+    bool init(GLsizeiptr regionSize, int regionCount = 3);
+
+    /**
+     * @brief Liberta o buffer e as fences pendentes
+     */
+    void destroy();
+
+    /**
+     * @brief Avança para a região seguinte, esperando pela GPU se ainda a estiver a usar
+     */
+    void beginFrame();
+
+    /**
+     * @brief Protege a região do frame com uma fence (depois dos desenhos que a usam)
+     */
+    void endFrame();
+
+    /**
+     * @brief Reserva uma fatia alinhada da região atual
+     * @param size Bytes pedidos
+     * @param alignment Alinhamento do deslocamento (potência de 2), ver getUniformAlignment()/getStorageAlignment()
+     * @return Fatia reservada; data == nullptr se a região não tiver espaço
+     */
+    StreamAllocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+
+    bool isReady() const { return mapped != nullptr; }
+    GLuint getBuffer() const { return buffer; }
+
+    GLsizeiptr getUniformAlignment() const { return uniformAlignment; }
+    GLsizeiptr getStorageAlignment() const { return storageAlignment; }
+
+    unsigned int getStallCount() const { return stallCount; }
+    double getStallMs() const { return stallSeconds * 1000.0; }
+    unsigned int getOverflowCount() const { return overflowCount; }
+
+private:
+    static const int MAX_REGIONS = 4;
+
+    GLuint buffer = 0;
+    unsigned char* mapped = nullptr;        // Início do mapeamento persistente
+    GLsizeiptr regionSize = 0;
+    int regionCount = 0;
+    int region = 0;                          // Região do frame atual
+    GLsizeiptr used = 0;                     // Bytes já reservados na região atual
+    GLsync fences[MAX_REGIONS] = {};         // nullptr = região livre
+
+    GLsizeiptr uniformAlignment = 256;       // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    GLsizeiptr storageAlignment = 256;       // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+
+    unsigned int stallCount = 0;             // Regiões ainda em uso pela GPU quando reutilizadas
+    double stallSeconds = 0.0;               // Tempo total de espera nesses casos
+    unsigned int overflowCount = 0;          // Pedidos recusados por falta de espaço
+};
\ No newline at end of file
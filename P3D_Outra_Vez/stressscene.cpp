@@ -0,0 +1,105 @@
+/***********************************************************************
+ * Implementação do Gerador de Cenas de Teste
+ ***********************************************************************/
+
+#include "stressscene.h"
+#include <algorithm>
+#include <cmath>
+
+// Posições do triângulo original, relativas ao centro da mesa
+static const glm::vec3 RACK[StressScene::BALL_TYPES] = {
+    {-1.0f, 1.0f, 0.0f},
+    {-1.8f, 1.0f, 0.5f}, {-1.8f, 1.0f, -0.5f},
+    {-2.6f, 1.0f, 1.0f}, {-2.6f, 1.0f, 0.0f}, {-2.6f, 1.0f, -1.0f},
+    {-3.4f, 1.0f, 1.5f}, {-3.4f, 1.0f, 0.5f}, {-3.4f, 1.0f, -0.5f}, {-3.4f, 1.0f, -1.5f},
+    {-4.2f, 1.0f, 2.0f}, {-4.2f, 1.0f, 1.0f}, {-4.2f, 1.0f, 0.0f}, {-4.2f, 1.0f, -1.0f}, {-4.2f, 1.0f, -2.0f}
+};
+
+static constexpr float BALL_SPACING = 1.2f;  // Distância entre bolas na grelha (diâmetro com folga)
+static constexpr float TABLE_GAP = 4.0f;     // Corredor entre mesas vizinhas
+static constexpr float LAMP_HEIGHT = 6.0f;   // Altura dos candeeiros acima do centro da mesa
+static constexpr float ACCENT_MIN_HEIGHT = 1.5f; // Alturas das luzes de destaque acima do centro das mesas
+static constexpr float ACCENT_MAX_HEIGHT = 4.0f;
+static constexpr float GOLDEN_ANGLE = 2.39996323f;
+
+SceneLayout StressScene::generate(const SceneConfig& config, const glm::vec3& tableCenter, const glm::vec3& tableHalfSize) {
+    SceneLayout layout;
+    const int tables = std::max(1, config.tables);
+    const int balls = std::max(0, config.ballsPerTable);
+
+    // Grelha de mesas o mais quadrada possível
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tables))));
+    const int rows = (tables + columns - 1) / columns;
+    const float stepX = 2.0f * tableHalfSize.x + TABLE_GAP;
+    const float stepZ = 2.0f * tableHalfSize.z + TABLE_GAP;
+    for (int i = 0; i < tables; ++i) {
+        const float x = (i % columns - (columns - 1) * 0.5f) * stepX;
+        const float z = (i / columns - (rows - 1) * 0.5f) * stepZ;
+        layout.tables.push_back(tableCenter + glm::vec3(x, 0.0f, z));
+    }
+    layout.radius = glm::length(glm::vec2(columns * stepX, rows * stepZ)) * 0.5f;
+
+    // Grelha do tampo para as bolas além do triângulo (camadas por cima dele)
+    const int gridColumns = std::max(1, static_cast<int>((2.0f * tableHalfSize.x - BALL_SPACING) / BALL_SPACING) + 1);
+    const int gridRows = std::max(1, static_cast<int>((2.0f * tableHalfSize.z - BALL_SPACING) / BALL_SPACING) + 1);
+    const int perLayer = gridColumns * gridRows;
+
+    layout.balls.reserve(static_cast<size_t>(tables) * balls);
+    layout.ballTypes.reserve(static_cast<size_t>(tables) * balls);
+    for (const glm::vec3& table : layout.tables) {
+        for (int i = 0; i < balls; ++i) {
+            glm::vec3 offset;
+            if (i < BALL_TYPES) {
+                offset = RACK[i];
+            }
+            else {
+                const int cell = (i - BALL_TYPES) % perLayer;
+                const int layer = (i - BALL_TYPES) / perLayer;
+                offset.x = (cell % gridColumns - (gridColumns - 1) * 0.5f) * BALL_SPACING;
+                offset.z = (cell / gridColumns - (gridRows - 1) * 0.5f) * BALL_SPACING;
+                offset.y = 1.0f + (layer + 1) * BALL_SPACING;
+            }
+            layout.balls.push_back(table + offset);
+            layout.ballTypes.push_back(i % BALL_TYPES);
+        }
+    }
+
+    // Candeeiros distribuídos ao longo do comprimento de cada mesa
+    for (const glm::vec3& table : layout.tables) {
+        for (int i = 0; i < LAMPS_PER_TABLE; ++i) {
+            const float x = ((i + 0.5f) / LAMPS_PER_TABLE - 0.5f) * 2.0f * tableHalfSize.x;
+            layout.lamps.push_back(table + glm::vec3(x, LAMP_HEIGHT, 0.0f));
+        }
+    }
+
+    // Luzes de destaque: espiral de área constante por luz, dentro da grelha de mesas
+    const int accents = std::max(0, config.accentLights);
+    const glm::vec2 extent(columns * stepX * 0.5f, rows * stepZ * 0.5f);
+    for (int i = 0; i < accents; ++i) {
+        const float t = (i + 0.5f) / accents;
+        const float angle = i * GOLDEN_ANGLE;
+        const float height = ACCENT_MIN_HEIGHT + (ACCENT_MAX_HEIGHT - ACCENT_MIN_HEIGHT) * (i % 5) / 4.0f;
+        layout.accents.push_back(tableCenter + glm::vec3(std::cos(angle) * std::sqrt(t) * extent.x, height,
+            std::sin(angle) * std::sqrt(t) * extent.y));
+    }
+    return layout;
+}
+
+bool StressScene::parseSharing(const std::string& name, AssetSharing& result) {
+    for (AssetSharing candidate : { SHARE_NONE, SHARE_TEXTURES, SHARE_MESHES }) {
+        if (name == sharingName(candidate)) {
+            result = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* StressScene::sharingName(AssetSharing value) {
+    switch (value) {
+    case SHARE_NONE: return "none";
+    case SHARE_TEXTURES: return "textures";
+    case SHARE_MESHES: return "meshes";
+    }
+    return "meshes";
+}
\ No newline at end of file
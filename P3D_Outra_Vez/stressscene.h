@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - string: nomes dos modos de partilha
+ * - vector: posições geradas
+ * - glm: posições no mundo
+ */
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Que recursos das bolas são partilhados entre instâncias do mesmo tipo
+ */
+enum AssetSharing {
+    SHARE_NONE,      // Cada bola lê o seu .obj, .mtl e textura do disco
+    SHARE_TEXTURES,  // Cada bola tem a sua geometria, mas as texturas são carregadas uma vez
+    SHARE_MESHES     // Um modelo por tipo de bola; as restantes são instâncias dele
+};
+
+/**
+ * @brief Dimensão da cena: número de mesas, bolas por mesa, partilha de recursos e luzes de destaque
+ *
+ * Os valores por omissão reproduzem a cena original (uma mesa com o
+ * triângulo de 15 bolas), iluminada pelos candeeiros das mesas.
+ */
+struct SceneConfig {
+    int tables = 1;
+    int ballsPerTable = 15;
+    AssetSharing sharing = SHARE_MESHES;
+    int accentLights = 0;    // Luzes pontuais espalhadas pela cena, além dos candeeiros
+};
+
+/**
+ * @brief Posições geradas para uma SceneConfig
+ */
+struct SceneLayout {
+    std::vector<glm::vec3> tables;   // Centro de cada mesa
+    std::vector<glm::vec3> balls;    // Posição de cada bola
+    std::vector<int> ballTypes;      // Tipo de cada bola (0..BALL_TYPES-1 -> PoolBalls/BallN.obj)
+    std::vector<glm::vec3> lamps;    // Candeeiros: LAMPS_PER_TABLE por cima de cada mesa
+    std::vector<glm::vec3> accents;  // Luzes de destaque, em espiral por cima das mesas
+    float radius = 0.0f;             // Raio do círculo (em XZ, centrado na origem) que contém as mesas
+};
+
+/**
+ * @brief Gerador de cenas de teste com N mesas x M bolas
+ *
+ * As mesas ficam numa grelha centrada na origem. Em cada mesa, as
+ * primeiras 15 bolas ocupam as posições do triângulo original; as
+ * seguintes formam grelhas regulares do tamanho do tampo, empilhadas
+ * em camadas por cima do triângulo. Cada mesa tem os seus candeeiros,
+ * alinhados ao longo do comprimento; as luzes de destaque seguem uma
+ * espiral de ângulo de ouro que cobre toda a grelha, a alturas variadas
+ * (as posições são as mesmas em todas as execuções).
+ */
+class StressScene {
+public:
+    static constexpr int BALL_TYPES = 15;
+    static constexpr int LAMPS_PER_TABLE = 2;
+
+    /**
+     * @brief Gera as posições das mesas e das bolas
+     * @param config Dimensão da cena
+     * @param tableCenter Centro da mesa original (a primeira mesa da grelha, com N = 1)
+     * @param tableHalfSize Metade da largura, altura e profundidade de uma mesa
+     */
+    static SceneLayout generate(const SceneConfig& config, const glm::vec3& tableCenter, const glm::vec3& tableHalfSize);
+
+    /**
+     * @brief Converte "none", "textures" ou "meshes" no modo de partilha
+     * @return false se o nome não for reconhecido
+     */
+    static bool parseSharing(const std::string& name, AssetSharing& result);
+
+    static const char* sharingName(AssetSharing value);
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+/***********************************************************************
+ * Implementação do Conjunto de Threads de Trabalho
+ ***********************************************************************/
+
+#include "taskpool.h"
+#include "cpuprofiler.h"
+
+void TaskPool::init(unsigned int workerCount) {
+    shutdown();
+    quit = false;
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&TaskPool::workerLoop, this);
+    }
+}
+
+void TaskPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void TaskPool::runTasks(const std::function<void(size_t)>& fn, size_t count) {
+    for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        fn(i);
+    }
+}
+
+void TaskPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    // Sem threads ou com uma só tarefa não compensa acordar ninguém
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        next = 0;
+        ++generation;
+    }
+    wake.notify_all();
+
+    // A thread chamadora também trabalha
+    runTasks(fn, count);
+
+    // Todos os índices foram atribuídos; espera que as threads que os têm terminem.
+    // Limpar job impede que uma thread acordada tarde entre num ciclo já concluído.
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this, count] { return active == 0 && next.load() >= count; });
+    job = nullptr;
+}
+
+void TaskPool::workerLoop() {
+    PROFILE_THREAD("worker");
+
+    unsigned long long seen = 0;
+    for (;;) {
+        const std::function<void(size_t)>* fn;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return quit || (job && generation != seen); });
+            if (quit) return;
+            seen = generation;
+            fn = job;
+            count = jobCount;
+            ++active;
+        }
+
+        runTasks(*fn, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --active;
+        }
+        done.notify_all();
+    }
+}
\ No newline at end of file
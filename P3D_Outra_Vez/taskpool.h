@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - vector, thread: threads de trabalho
+ * - mutex, condition_variable, atomic: distribuição das tarefas
+ * - functional: corpo das tarefas
+ */
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Conjunto fixo de threads de trabalho para ciclos paralelos
+ *
+ * parallelFor(n, fn) executa fn(0) .. fn(n - 1) repartidas entre as
+ * threads de trabalho e a thread que a chama; cada thread vai buscando o
+ * próximo índice livre, por isso tarefas desiguais equilibram-se
+ * sozinhas. A chamada só retorna quando todas as tarefas terminaram.
+ *
+ * As threads são criadas uma única vez e ficam à espera entre ciclos.
+ */
+class TaskPool {
+public:
+    ~TaskPool() { shutdown(); }
+
+    /**
+     * @brief Cria as threads de trabalho
+     * @param workerCount Número de threads além da chamadora (0 = tudo na chamadora)
+     */
+    void init(unsigned int workerCount);
+
+    /**
+     * @brief Termina as threads de trabalho
+     */
+    void shutdown();
+
+    /**
+     * @brief Executa fn(i) para cada i em [0, count) e espera pelo fim
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    void workerLoop();
+    void runTasks(const std::function<void(size_t)>& fn, size_t count);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;          // Novo ciclo ou fim
+    std::condition_variable done;          // Uma thread de trabalho saiu do ciclo
+
+    const std::function<void(size_t)>* job = nullptr; // Ciclo em curso (nullptr = nenhum)
+    size_t jobCount = 0;
+    std::atomic<size_t> next{ 0 };         // Próximo índice por atribuir
+    unsigned long long generation = 0;     // Incrementado a cada ciclo
+    unsigned int active = 0;               // Threads de trabalho dentro do ciclo atual
+    bool quit = false;
+};
\ No newline at end of file
@@ -0,0 +1,131 @@
+/***********************************************************************
+ * Implementação do Armazenamento de Transformações (SoA)
+ *
+ * As matrizes de mundo são recalculadas apenas para as transformações
+ * marcadas como alteradas, 4 de cada vez com instruções SSE.
+ ***********************************************************************/
+
+#include "transform.h"
+#include <immintrin.h>
+
+TransformHandle TransformStore::create(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& scale) {
+    const TransformHandle h = static_cast<TransformHandle>(world.size());
+
+    posX.push_back(position.x); posY.push_back(position.y); posZ.push_back(position.z);
+    rotX.push_back(orientation.x); rotY.push_back(orientation.y);
+    rotZ.push_back(orientation.z); rotW.push_back(orientation.w);
+    scaleX.push_back(scale.x); scaleY.push_back(scale.y); scaleZ.push_back(scale.z);
+    world.push_back(glm::mat4(1.0f));
+
+    if ((h >> 6) >= dirty.size()) {
+        dirty.push_back(0);
+    }
+    markDirty(h);
+    return h;
+}
+
+void TransformStore::markDirty(TransformHandle h) {
+    dirty[h >> 6] |= uint64_t(1) << (h & 63);
+    ++changeCount;
+}
+
+void TransformStore::setPosition(TransformHandle h, const glm::vec3& position) {
+    posX[h] = position.x; posY[h] = position.y; posZ[h] = position.z;
+    markDirty(h);
+}
+
+void TransformStore::setOrientation(TransformHandle h, const glm::quat& orientation) {
+    rotX[h] = orientation.x; rotY[h] = orientation.y;
+    rotZ[h] = orientation.z; rotW[h] = orientation.w;
+    markDirty(h);
+}
+
+void TransformStore::setScale(TransformHandle h, const glm::vec3& scale) {
+    scaleX[h] = scale.x; scaleY[h] = scale.y; scaleZ[h] = scale.z;
+    markDirty(h);
+}
+
+void TransformStore::rotate(TransformHandle h, const glm::quat& delta) {
+    // Renormaliza para que erros de arredondamento não se acumulem
+    setOrientation(h, glm::normalize(delta * getOrientation(h)));
+}
+
+/**
+ * @brief Recalcula as matrizes sujas em lotes de 4
+ *
+ * Cada lane SSE processa uma transformação: a matriz de rotação é obtida
+ * diretamente do quaternião, cada linha é multiplicada pela escala do
+ * eixo correspondente (S * R) e a translação ocupa a última coluna.
+ */
+size_t TransformStore::update() {
+    // Recolhe os índices com o bit sujo ativo
+    pending.clear();
+    for (size_t word = 0; word < dirty.size(); ++word) {
+        uint64_t bits = dirty[word];
+        while (bits) {
+            unsigned int bit = 0;
+            while (!((bits >> bit) & 1)) ++bit;
+            pending.push_back(static_cast<TransformHandle>(word * 64 + bit));
+            bits &= bits - 1;
+        }
+        dirty[word] = 0;
+    }
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    for (size_t i = 0; i < pending.size(); i += 4) {
+        // Completa o último lote repetindo o último índice
+        TransformHandle idx[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            idx[lane] = pending[(i + lane < pending.size()) ? i + lane : pending.size() - 1];
+        }
+
+#define GATHER(arr) _mm_setr_ps(arr[idx[0]], arr[idx[1]], arr[idx[2]], arr[idx[3]])
+        const __m128 x = GATHER(rotX), y = GATHER(rotY), z = GATHER(rotZ), w = GATHER(rotW);
+        const __m128 sx = GATHER(scaleX), sy = GATHER(scaleY), sz = GATHER(scaleZ);
+        const __m128 tx = GATHER(posX), ty = GATHER(posY), tz = GATHER(posZ);
+#undef GATHER
+
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Matriz de rotação R[coluna][linha]
+        const __m128 r00 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+        const __m128 r01 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+        const __m128 r02 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+        const __m128 r10 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+        const __m128 r11 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+        const __m128 r12 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+        const __m128 r20 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+        const __m128 r21 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+        const __m128 r22 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+        // S * R: a linha i de R é multiplicada pela escala do eixo i
+        alignas(16) float m[12][4];
+        _mm_store_ps(m[0], _mm_mul_ps(r00, sx));
+        _mm_store_ps(m[1], _mm_mul_ps(r01, sy));
+        _mm_store_ps(m[2], _mm_mul_ps(r02, sz));
+        _mm_store_ps(m[3], _mm_mul_ps(r10, sx));
+        _mm_store_ps(m[4], _mm_mul_ps(r11, sy));
+        _mm_store_ps(m[5], _mm_mul_ps(r12, sz));
+        _mm_store_ps(m[6], _mm_mul_ps(r20, sx));
+        _mm_store_ps(m[7], _mm_mul_ps(r21, sy));
+        _mm_store_ps(m[8], _mm_mul_ps(r22, sz));
+        _mm_store_ps(m[9], tx);
+        _mm_store_ps(m[10], ty);
+        _mm_store_ps(m[11], tz);
+
+        // Escreve cada lane na matriz de mundo correspondente
+        for (int lane = 0; lane < 4; ++lane) {
+            glm::mat4& out = world[idx[lane]];
+            out[0] = glm::vec4(m[0][lane], m[1][lane], m[2][lane], 0.0f);
+            out[1] = glm::vec4(m[3][lane], m[4][lane], m[5][lane], 0.0f);
+            out[2] = glm::vec4(m[6][lane], m[7][lane], m[8][lane], 0.0f);
+            out[3] = glm::vec4(m[9][lane], m[10][lane], m[11][lane], 1.0f);
+        }
+    }
+
+    return pending.size();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - cstdint: palavras do conjunto de bits "sujo"
+ * - vector: arrays contíguos de cada componente
+ * - glm: vetores, quaterniões e matrizes
+ */
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Identificador de uma transformação dentro do TransformStore
+typedef uint32_t TransformHandle;
+
+/**
+ * @brief Armazenamento structure-of-arrays das transformações da cena
+ *
+ * Cada componente (posição, orientação, escala) fica num array próprio e
+ * contíguo, e a matriz de mundo de cada objeto é guardada em cache.
+ * Alterar uma transformação apenas marca o seu bit no conjunto "sujo";
+ * update() recalcula, uma vez por frame e em lotes SIMD de 4, só as
+ * matrizes marcadas.
+ *
+ * A orientação é um quaternião, para que objetos a rolar possam acumular
+ * rotações sem conversões para ângulos de Euler.
+ *
+ * A matriz de mundo segue a ordem usada pelo ObjModel: M = T * S * R.
+ */
+class TransformStore {
+public:
+    /**
+     * @brief Cria uma transformação e devolve o seu identificador
+     */
+    TransformHandle create(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& scale);
+
+    void setPosition(TransformHandle h, const glm::vec3& position);
+    void setOrientation(TransformHandle h, const glm::quat& orientation);
+    void setScale(TransformHandle h, const glm::vec3& scale);
+
+    /**
+     * @brief Compõe uma rotação incremental com a orientação atual (q = delta * q)
+     */
+    void rotate(TransformHandle h, const glm::quat& delta);
+
+    glm::vec3 getPosition(TransformHandle h) const { return glm::vec3(posX[h], posY[h], posZ[h]); }
+    glm::quat getOrientation(TransformHandle h) const { return glm::quat(rotW[h], rotX[h], rotY[h], rotZ[h]); }
+    glm::vec3 getScale(TransformHandle h) const { return glm::vec3(scaleX[h], scaleY[h], scaleZ[h]); }
+
+    /**
+     * @brief Matriz de mundo em cache (válida depois de update())
+     */
+    const glm::mat4& getWorldMatrix(TransformHandle h) const { return world[h]; }
+
+    /**
+     * @brief Recalcula as matrizes de mundo das transformações alteradas
+     * @return Número de matrizes recalculadas
+     */
+    size_t update();
+
+    bool isDirty(TransformHandle h) const { return (dirty[h >> 6] >> (h & 63)) & 1; }
+    size_t size() const { return world.size(); }
+
+    /**
+     * @brief Contador incrementado em cada alteração (para detetar mudanças na cena)
+     */
+    unsigned long long getChangeCount() const { return changeCount; }
+
+private:
+    void markDirty(TransformHandle h);
+
+    // Componentes em arrays separados (SoA)
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> rotX, rotY, rotZ, rotW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+
+    std::vector<glm::mat4> world;        // Matrizes de mundo em cache
+    std::vector<uint64_t> dirty;         // Um bit por transformação
+    std::vector<TransformHandle> pending;// Lista temporária usada por update()
+    unsigned long long changeCount = 0;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+/**
+ * Inclusões necessárias:
+ * - atomic: troca dos índices entre as duas threads sem locks
+ * - cstdint: índices compactos
+ */
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Buffer triplo sem locks entre um produtor e um consumidor
+ *
+ * Cada thread tem o seu próprio buffer (escrita e leitura) e o terceiro
+ * fica "no meio". Publicar troca o buffer de escrita com o do meio;
+ * atualizar troca o de leitura com o do meio, se este tiver sido
+ * publicado desde a última leitura. Nenhuma das threads espera pela
+ * outra: o produtor pode publicar várias vezes entre duas leituras (só a
+ * última é vista) e o consumidor pode reler o mesmo valor várias vezes.
+ *
+ * O produtor deve escrever o valor completo antes de cada publicação,
+ * porque o buffer que recebe de volta contém um valor antigo.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief Buffer onde o produtor escreve o próximo valor
+     */
+    T& writeBuffer() { return slots[backIndex]; }
+
+    /**
+     * @brief Torna o buffer de escrita visível ao consumidor
+     */
+    void publish() {
+        const uint8_t previous = middle.exchange(static_cast<uint8_t>(backIndex | FRESH), std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Passa a ler o valor publicado mais recente, se existir
+     * @return true se o buffer de leitura mudou
+     */
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        const uint8_t previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Último valor obtido por update() (só o consumidor o usa)
+     */
+    const T& readBuffer() const { return slots[frontIndex]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4;     // O buffer do meio ainda não foi lido
+
+    T slots[3];
+    std::atomic<uint8_t> middle{ 1 };     // Índice do meio | FRESH
+    uint8_t backIndex = 0;                // Só o produtor o usa
+    uint8_t frontIndex = 2;               // Só o consumidor o usa
+};
\ No newline at end of file